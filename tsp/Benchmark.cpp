@@ -0,0 +1,297 @@
+#include "Benchmark.h"
+
+/**
+ * Executes the benchmark selected at run time.
+ *
+ * @param[in] cities the dataset of the benchmark
+ * @param[in] settings the run time settings (benchmark name)
+ *
+ * @return false if the benchmark is unknown, else true
+ */
+bool run_benchmark(const Instance& cities, const Settings& settings)
+{
+    if (settings.benchmark == "construction") { benchmark_construction(cities, settings); }
+    else if (settings.benchmark == "deposits") { benchmark_deposits(cities, settings); }
+    else if (settings.benchmark == "kernel") { benchmark_kernel(cities, settings); }
+    else if (settings.benchmark == "selection") { benchmark_selection(settings); }
+    else if (settings.benchmark == "local-search") { benchmark_local_search(cities, settings); }
+    else
+    {
+        std::cout << "[Warning]: Unknown benchmark \"" << settings.benchmark << "\"\n\t[\"Unknown benchmark\" fault masked]" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Measures the deposit modes of the parallel ACS, from 1 up to `BENCHMARK_MAX_THREADS` threads.
+ *
+ * @param[in] cities the dataset of the benchmark
+ * @param[in] settings the run time settings (candidate lists and pherormone store)
+ *
+ * @note each thread runs one ant, so the work grows with the number of threads. The table
+ *      reports the throughput in ant steps per second, which grows along with the number of
+ *      threads when the colonization scales perfectly, and the speedup of each mode over its
+ *      single thread run. Beyond the number of processors, the speedup can only drop.
+ */
+void benchmark_deposits(const Instance& cities, const Settings& settings)
+{
+    CandidateList candidates;
+    build_candidates(cities, settings.candidates, settings.quadrant_candidates, candidates);
+    const int store = (settings.pherormone == PHERORMONE_AUTO ? PHERORMONE_SPARSE : settings.pherormone);
+                                                            /// The sweep of a dense store would hide the deposits, so the sparse store is the default
+    const std::array<std::pair<int, std::string>, 3> modes = {
+        std::make_pair(DEPOSIT_CRITICAL, std::string("critical")),
+        std::make_pair(DEPOSIT_ATOMIC, std::string("atomic")),
+        std::make_pair(DEPOSIT_BUFFERED, std::string("buffered"))
+    };
+    auto colonize_seconds = [&](const Settings& run)        /// Colonizes the map with a fresh pherormone store and returns the elapsed time
+    {
+        ColonyTours tours;
+        std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+        with_pherormone_store(candidates, cities.size(), run, [&](auto& pherormone)
+        {
+            colonize_parallel(cities, candidates, run, pherormone, tours);
+        });
+        std::chrono::duration<double> elapsed_seconds = std::chrono::system_clock::now() - start;
+        return elapsed_seconds.count();
+    };
+
+    std::cout << "Deposit benchmark on " << cities.size() << " cities (" << BENCHMARK_ITERATIONS << " iterations, "
+        << omp_get_num_procs() << " processors, ant steps per second and speedup over 1 thread)" << std::endl;
+    std::cout << std::setw(10) << "Threads";
+    for (const auto& mode : modes) { std::cout << std::setw(24) << mode.second; }
+    std::cout << std::endl;
+    std::array<double, 3> single_thread = { 0.0, 0.0, 0.0 };
+    for (int threads = 1; threads <= BENCHMARK_MAX_THREADS; threads *= 2)
+    {
+        std::cout << std::setw(10) << threads;
+        for (int m = 0; m < (int)modes.size(); m += 1)
+        {
+            Settings run = settings;
+            run.ants = threads;
+            run.iterations = BENCHMARK_ITERATIONS;
+            run.deposit = modes[m].first;
+            run.progress = false;
+            run.track_best = false;                         /// Only the colonization is measured
+            run.pherormone = store;
+            const double steps = (double)threads * BENCHMARK_ITERATIONS * (std::min(ANT_MEMORY, cities.size()) - 1);
+            const double throughput = steps / colonize_seconds(run);
+            if (threads == 1) { single_thread[m] = throughput; }
+            std::cout << std::setw(14) << std::fixed << std::setprecision(0) << throughput
+                << " (x" << std::setw(5) << std::setprecision(2) << throughput / single_thread[m] << ")";
+        }
+        std::cout << std::endl;
+    }
+}
+
+/**
+ * Measures the kernels that evaluate the edges of an ant step, for blocks of 1,000 up to 100,000 edges.
+ *
+ * @param[in] cities the dataset of the benchmark
+ * @param[in] settings the run time settings (seed and instruction set)
+ *
+ * @note the edges start at the first city and end at cities picked at random, so the gathers
+ *      of the coordinates miss the cache as they do in the fallback path of an ant step. The
+ *      table reports the nanoseconds per edge of each instruction set supported by the processor,
+ *      and the speedup over the scalar kernel.
+ */
+void benchmark_kernel(const Instance& cities, const Settings& settings)
+{
+    constexpr long long edges_per_run = 20000000;           /// The number of edges evaluated for each entry of the table
+    select_simd(SIMD_AUTO);
+    const int widest = simd_level();
+    Xoshiro256 gen = random_stream((uint64_t)settings.seed, STREAM_MAIN);
+    std::uniform_int_distribution<int> city(1, cities.size() - 1);
+
+    std::cout << "Kernel benchmark on " << cities.size() << " cities (nanoseconds per edge and speedup over scalar)" << std::endl;
+    std::cout << std::setw(10) << "Edges";
+    for (int level = SIMD_SCALAR; level <= SIMD_AVX512; level += 1) { std::cout << std::setw(20) << simd_name(level); }
+    std::cout << std::endl;
+    double checksum = 0.0;                                  /// Keeps the compiler from discarding the evaluations
+    for (int size = 1000; size <= 100000; size *= 10)
+    {
+        std::vector<int> targets(size);
+        std::vector<double> tau(size, 1.0);
+        std::vector<double> attractiveness(size);
+        for (int& target : targets) { target = city(gen); }
+        const int runs = (int)std::max(1LL, edges_per_run / size);
+        std::cout << std::setw(10) << size;
+        double scalar = 0.0;
+        for (int level = SIMD_SCALAR; level <= SIMD_AVX512; level += 1)
+        {
+            if (level > widest)
+            {
+                std::cout << std::setw(20) << "n/a";
+                continue;
+            }
+            std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+            for (int run = 0; run < runs; run += 1)
+            {
+                for (int i = 0; i < size; i += EVALUATION_BLOCK)
+                {
+                    edge_attractiveness(cities, 0, targets.data() + i, tau.data() + i, std::min(EVALUATION_BLOCK, size - i), attractiveness.data() + i, level);
+                }
+                checksum += attractiveness[run % size];
+            }
+            std::chrono::duration<double> elapsed_seconds = std::chrono::system_clock::now() - start;
+            const double nanoseconds = 1e9 * elapsed_seconds.count() / ((double)runs * size);
+            if (level == SIMD_SCALAR) { scalar = nanoseconds; }
+            std::cout << std::setw(11) << std::fixed << std::setprecision(2) << nanoseconds
+                << " (x" << std::setw(5) << std::setprecision(2) << scalar / nanoseconds << ")";
+        }
+        std::cout << std::endl;
+    }
+    std::cout << "Checksum: " << std::defaultfloat << std::setprecision(6) << checksum << std::endl;
+    select_simd(settings.simd);
+}
+
+/**
+ * Measures the selection methods of the ants, for 1,000 up to 100,000 evaluated edges.
+ *
+ * @param[in] settings the run time settings (seed)
+ *
+ * @note the evaluations are drawn at random, as in the fallback path of an ant step, where every
+ *      unexplored city is evaluated. The methods that reorder the evaluations run on a fresh copy
+ *      of them, and every method pays for that copy alike. The table reports the nanoseconds per
+ *      selection of each method, and the speedup over the original roulette wheel.
+ */
+void benchmark_selection(const Settings& settings)
+{
+    constexpr long long edges_per_run = 50000000;           /// The number of evaluations scanned for each entry of the table
+    const std::array<std::pair<int, std::string>, 4> methods = {
+        std::make_pair(SELECTION_SORT, std::string("sort")),
+        std::make_pair(SELECTION_TOP_K, std::string("top-k")),
+        std::make_pair(SELECTION_PROPORTIONAL, std::string("proportional")),
+        std::make_pair(SELECTION_TOURNAMENT, std::string("tournament"))
+    };
+    Xoshiro256 gen = random_stream((uint64_t)settings.seed, STREAM_MAIN);
+    std::uniform_real_distribution<double> evaluation_dist(0, 1);
+
+    std::cout << "Selection benchmark (nanoseconds per selection and speedup over sort)" << std::endl;
+    std::cout << std::setw(10) << "Edges";
+    for (const auto& method : methods) { std::cout << std::setw(22) << method.second; }
+    std::cout << std::endl;
+    long long checksum = 0;                                 /// Keeps the compiler from discarding the selections
+    for (int size = 1000; size <= 100000; size *= 10)
+    {
+        std::vector<std::pair<int, double>> evaluation(size);
+        for (int i = 0; i < size; i += 1) { evaluation[i] = std::make_pair(i, evaluation_dist(gen)); }
+        std::vector<std::pair<int, double>> scratch;
+        scratch.reserve(size);
+        const int runs = (int)std::max(1LL, edges_per_run / size);
+        std::cout << std::setw(10) << size;
+        double sort = 0.0;
+        for (const auto& method : methods)
+        {
+            std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+            for (int run = 0; run < runs; run += 1)
+            {
+                scratch.assign(evaluation.begin(), evaluation.end());
+                checksum += select_edge(scratch, method.first, gen);
+            }
+            std::chrono::duration<double> elapsed_seconds = std::chrono::system_clock::now() - start;
+            const double nanoseconds = 1e9 * elapsed_seconds.count() / runs;
+            if (method.first == SELECTION_SORT) { sort = nanoseconds; }
+            std::cout << std::setw(12) << std::fixed << std::setprecision(0) << nanoseconds
+                << " (x" << std::setw(6) << std::setprecision(2) << sort / nanoseconds << ")";
+        }
+        std::cout << std::endl;
+    }
+    std::cout << "Checksum: " << checksum << std::endl;
+}
+
+/**
+ * Measures the parallel local search against the serial one, with 1, 4, 12 and 32 threads.
+ *
+ * @param[in] cities the dataset of the benchmark
+ * @param[in] settings the run time settings (local search flags and candidate lists)
+ *
+ * @note every run improves the same nearest neighbor route, with 2-opt and Or-opt moves unless
+ *      other moves are selected. The parallel engine applies the best moves first, so its local
+ *      optimum differs from the local optimum of the serial engine, and the table reports the
+ *      cost of both along with the speedup. Beyond the number of processors, the speedup can only drop.
+ */
+void benchmark_local_search(const Instance& cities, const Settings& settings)
+{
+    constexpr std::array<int, 4> thread_counts = { 1, 4, 12, 32 };
+    const int moves = (settings.local_search != 0 ? settings.local_search : LOCAL_SEARCH_2OPT | LOCAL_SEARCH_OROPT);
+    Instance ordered = cities;                              /// The nearest neighbor approach reorders the cities along its route
+    CandidateList candidates;
+    build_candidates(ordered, settings.candidates, settings.quadrant_candidates, candidates);
+    heinritz_hsiao(ordered, candidates);
+    std::vector<int> initial_route(ordered.size());
+    std::iota(initial_route.begin(), initial_route.end(), 0);
+    auto improve = [&](const int threads)                   /// Improves a fresh copy of the route and returns the elapsed time, the moves and the cost
+    {
+        Tour tour(initial_route);
+        std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+        const int applied = (threads == 0 ? local_optimum(ordered, candidates, moves, tour) : local_optimum_parallel(ordered, candidates, moves, tour, threads));
+        std::chrono::duration<double> elapsed_seconds = std::chrono::system_clock::now() - start;
+        std::vector<int> route;
+        tour.to_route(route);
+        return std::make_tuple(elapsed_seconds.count(), applied, tsp_route_cost(route, ordered));
+    };
+
+    std::cout << "Local search benchmark on " << cities.size() << " cities (" << omp_get_num_procs() << " processors, nearest neighbor route of cost "
+        << std::fixed << std::setprecision(2) << tsp_route_cost(initial_route, ordered) << ")" << std::endl;
+    std::cout << std::setw(10) << "Engine" << std::setw(10) << "Threads" << std::setw(12) << "Seconds" << std::setw(12) << "Moves"
+        << std::setw(16) << "Cost" << std::setw(10) << "Speedup" << std::endl;
+    const auto serial = improve(0);
+    std::cout << std::setw(10) << "serial" << std::setw(10) << 1 << std::setw(12) << std::setprecision(3) << std::get<0>(serial)
+        << std::setw(12) << std::get<1>(serial) << std::setw(16) << std::setprecision(2) << std::get<2>(serial) << std::setw(10) << 1.0 << std::endl;
+    for (const int threads : thread_counts)
+    {
+        const auto parallel = improve(threads);
+        std::cout << std::setw(10) << "parallel" << std::setw(10) << threads << std::setw(12) << std::setprecision(3) << std::get<0>(parallel)
+            << std::setw(12) << std::get<1>(parallel) << std::setw(16) << std::setprecision(2) << std::get<2>(parallel) << std::setw(10) << std::get<0>(serial) / std::get<0>(parallel) << std::endl;
+    }
+}
+
+/**
+ * Measures the construction heuristics against the nearest neighbor approach, on tour quality and wall time.
+ *
+ * @param[in] cities the dataset of the benchmark
+ * @param[in] settings the run time settings (candidate lists)
+ *
+ * @note the candidate lists are built once, outside of the measured time, since every heuristic but the
+ *      space filling curve consumes them. The nearest neighbor approach reorders a copy of the cities, and
+ *      the renumbering of the candidate lists that it requires is part of its time.
+ */
+void benchmark_construction(const Instance& cities, const Settings& settings)
+{
+    CandidateList candidates;
+    build_candidates(cities, settings.candidates, settings.quadrant_candidates, candidates);
+    auto construct = [&](const std::function<void(std::vector<int>&)>& heuristic)
+    {                                                       /// Builds a route and returns the elapsed time and its cost
+        std::vector<int> route;
+        std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+        heuristic(route);
+        std::chrono::duration<double> elapsed_seconds = std::chrono::system_clock::now() - start;
+        return std::make_pair(elapsed_seconds.count(), tsp_route_cost(route, cities));
+    };
+    const std::vector<std::pair<std::string, std::function<void(std::vector<int>&)>>> heuristics = {
+        { "nearest", [&](std::vector<int>& route)
+            {
+                Instance ordered = cities;
+                std::iota(ordered.id.begin(), ordered.id.end(), 0); /// The ids may differ from the indices, if the cities were renumbered
+                CandidateList ordered_candidates = candidates;
+                heinritz_hsiao(ordered, ordered_candidates);
+                route.assign(ordered.id.begin(), ordered.id.end());
+            } },                                            /// The ids of the reordered cities are the route over `cities`
+        { "greedy", [&](std::vector<int>& route) { greedy_edge(cities, candidates, route); } },
+        { "savings", [&](std::vector<int>& route) { savings(cities, candidates, route); } },
+        { "hilbert", [&](std::vector<int>& route) { space_filling_curve(cities, route); } }
+    };
+
+    std::cout << "Construction benchmark on " << cities.size() << " cities (" << omp_get_num_procs() << " processors, " << candidates.k << " candidates)" << std::endl;
+    std::cout << std::setw(10) << "Heuristic" << std::setw(12) << "Seconds" << std::setw(16) << "Cost" << std::setw(12) << "Excess" << std::endl;
+    double nearest = 0.0;
+    for (const auto& heuristic : heuristics)
+    {
+        const std::pair<double, double> result = construct(heuristic.second);
+        if (heuristic.first == "nearest") { nearest = result.second; }
+        std::cout << std::setw(10) << heuristic.first << std::setw(12) << std::fixed << std::setprecision(3) << result.first
+            << std::setw(16) << std::setprecision(2) << result.second << std::setw(11) << 100.0 * (result.second / nearest - 1.0) << "%" << std::endl;
+    }
+}
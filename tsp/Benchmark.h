@@ -0,0 +1,32 @@
+/**
+ * Benchmark.h
+ *
+ * In this header file, we define the benchmarks of the
+ * project. A benchmark measures a single component of an
+ * algorithm on the dataset of the run, over a range of
+ * sizes or thread counts, and prints a table with the results. A
+ * benchmark is selected at run time with `--benchmark`,
+ * in which case no algorithm is executed.
+ */
+
+#pragma once
+
+#include "Common.h"
+#include "Instance.h"
+#include "Candidates.h"
+#include "Colonize.h"
+#include "Construction.h"
+#include "Kernel.h"
+#include "Pherormone.h"
+#include "Random.h"
+#include "Selection.h"
+#include "LocalSearch.h"
+#include "Utilities.h"
+#include "Hilbert.h"
+
+bool run_benchmark(const Instance& cities, const Settings& settings);
+void benchmark_deposits(const Instance& cities, const Settings& settings);
+void benchmark_kernel(const Instance& cities, const Settings& settings);
+void benchmark_selection(const Settings& settings);
+void benchmark_local_search(const Instance& cities, const Settings& settings);
+void benchmark_construction(const Instance& cities, const Settings& settings);
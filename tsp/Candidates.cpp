@@ -0,0 +1,142 @@
+#include "Candidates.h"
+
+/**
+ * Sorts the candidates of a city in ascending distance.
+ *
+ * @param[in, out] neighbors the candidates of the city
+ * @param[in, out] distances the distances from the city to its candidates
+ * @param[in] k the number of candidates
+ */
+void sort_candidates(int* neighbors, double* distances, const int k)
+{
+    for (int i = 1; i < k; i += 1)                          /// Insertion sort, since `k` is small
+    {
+        const int neighbor = neighbors[i];
+        const double distance = distances[i];
+        int j = i;
+        while (j > 0 && distances[j - 1] > distance)
+        {
+            neighbors[j] = neighbors[j - 1];
+            distances[j] = distances[j - 1];
+            j -= 1;
+        }
+        neighbors[j] = neighbor;
+        distances[j] = distance;
+    }
+}
+
+/**
+ * Builds the candidate lists of an instance.
+ *
+ * @param[in] cities the instance
+ * @param[in] k the number of candidates of each city. It is clamped to `n_points` - 1
+ * @param[in] quadrant if true, up to `k` / 4 candidates are taken from each quadrant around a city and the rest
+ *      are the nearest remaining cities, else the candidates are the `k` nearest cities
+ * @param[in, out] candidates the candidate lists to be built
+ *
+ * @note the lists are built in parallel. For instances where the nearest city in the plane is also
+ *      the nearest city with respect to the metric, each list is a k-d tree query (see `KdTree.h`)
+ *      and the whole construction costs O(n k log n). Otherwise, each list is found by scanning all
+ *      the cities, which costs O(n^2) and is only meant for the small `GEO` and `EXPLICIT` instances.
+ */
+void build_candidates(const Instance& cities, const int k, const bool quadrant, CandidateList& candidates)
+{
+    const int n_points = cities.size();
+    candidates.k = std::max(1, std::min(k, n_points - 1));
+    candidates.neighbors.assign((size_t)n_points * candidates.k, -1);
+    candidates.distances.assign((size_t)n_points * candidates.k, 0.0);
+
+    if (cities.is_geometric())
+    {
+        const KdTree tree(cities);
+        const int per_quadrant = std::max(1, candidates.k / 4);
+#pragma omp parallel num_threads(N_THREADS)
+        {
+            std::vector<int> best_idx(candidates.k);            /// Each thread owns its query buffers
+            std::vector<double> best_val(candidates.k);
+#pragma omp for schedule(dynamic, 1024)
+            for (int p = 0; p < n_points; p += 1)
+            {
+                const int i = tree.city_at(p);                  /// Visit the cities in tree order, so that consecutive queries touch the same nodes
+                int* neighbors = candidates.neighbors.data() + (size_t)i * candidates.k;
+                double* distances = candidates.distances.data() + (size_t)i * candidates.k;
+                int found = 0;
+                if (quadrant)
+                {
+                    for (int q = 0; q < 4 && found < candidates.k; q += 1)
+                    {                                           /// Take the nearest cities of each quadrant
+                        const int in_quadrant = tree.k_nearest(i, std::min(per_quadrant, candidates.k - found), q, best_idx.data(), best_val.data());
+                        std::copy(best_idx.begin(), best_idx.begin() + in_quadrant, neighbors + found);
+                        found += in_quadrant;
+                    }
+                }
+                const int nearest = tree.k_nearest(i, candidates.k, -1, best_idx.data(), best_val.data());
+                for (int j = 0; j < nearest && found < candidates.k; j += 1)
+                {                                               /// Fill the list with the nearest cities that are not already in it
+                    if (std::find(neighbors, neighbors + found, best_idx[j]) == neighbors + found)
+                    {
+                        neighbors[found] = best_idx[j];
+                        found += 1;
+                    }
+                }
+                for (int j = 0; j < found; j += 1)
+                {
+                    distances[j] = tsp_hop_cost(cities, i, neighbors[j]).second;
+                }
+                sort_candidates(neighbors, distances, found);
+            }
+        }
+        return;
+    }
+
+#pragma omp parallel num_threads(N_THREADS)
+    {
+        std::vector<std::pair<double, int>> scan(n_points - 1);    /// Each thread owns its scan buffer
+#pragma omp for schedule(dynamic, 16)
+        for (int i = 0; i < n_points; i += 1)
+        {
+            int m = 0;
+            for (int j = 0; j < n_points; j += 1)
+            {
+                if (j != i) { scan[m++] = std::make_pair((double)tsp_hop_cost(cities, i, j).second, j); }
+            }
+            std::partial_sort(scan.begin(), scan.begin() + candidates.k, scan.end());
+            for (int j = 0; j < candidates.k; j += 1)
+            {
+                candidates.neighbors[(size_t)i * candidates.k + j] = scan[j].second;
+                candidates.distances[(size_t)i * candidates.k + j] = scan[j].first;
+            }
+        }
+    }
+}
+
+/**
+ * Renumbers the candidate lists after the cities of the instance have been reordered.
+ *
+ * @param[in] order the reordering, where the `i`-th city became the city `order[i]` (see `Instance::reorder()`)
+ * @param[in, out] candidates the candidate lists to be renumbered
+ *
+ * @note this costs O(n k), which is much cheaper than building the lists again.
+ */
+void reorder_candidates(const std::vector<int>& order, CandidateList& candidates)
+{
+    const int n_points = (int)order.size();
+    std::vector<int> inverse(n_points);                     /// Maps the old index of a city to its new index
+    for (int i = 0; i < n_points; i += 1)
+    {
+        inverse[order[i]] = i;
+    }
+    std::vector<int> neighbors(candidates.neighbors.size());
+    std::vector<double> distances(candidates.distances.size());
+#pragma omp parallel for num_threads(N_THREADS) schedule(static)
+    for (int i = 0; i < n_points; i += 1)
+    {
+        for (int j = 0; j < candidates.k; j += 1)
+        {
+            neighbors[(size_t)i * candidates.k + j] = inverse[candidates.neighbors[(size_t)order[i] * candidates.k + j]];
+            distances[(size_t)i * candidates.k + j] = candidates.distances[(size_t)order[i] * candidates.k + j];
+        }
+    }
+    candidates.neighbors.swap(neighbors);
+    candidates.distances.swap(distances);
+}
@@ -0,0 +1,41 @@
+/**
+ * Candidates.h
+ *
+ * In this header file, we define the candidate lists of
+ * the project. A candidate list holds, for every city, a
+ * small number `k` of promising neighbors (either its `k`
+ * nearest cities or the nearest cities of each quadrant
+ * around it) along with their precomputed distances. The
+ * lists are stored as flat `n_points` x `k` arrays, so that
+ * the ACS, the local search moves and the nearest neighbor
+ * approaches consider O(k) edges per city instead of O(n).
+ *
+ * @remark http://akira.ruc.dk/~keld/research/LKH/LKH-2.0/DOC/LKH_REPORT.pdf
+ */
+
+#pragma once
+
+#include "Common.h"
+#include "KdTree.h"
+#include "Distance.h"
+#include "Instance.h"
+
+/**
+ * The candidate neighbors of every city of an instance.
+ *
+ * @note the candidates of each city are sorted in ascending distance.
+ */
+struct CandidateList
+{
+    int k = 0;                                              /// The number of candidates of each city
+    std::vector<int> neighbors;                             /// The `n_points` x `k` candidate cities
+    std::vector<double> distances;                          /// The `n_points` x `k` distances from each city to its candidates
+
+    const int* neighbors_of(const int city) const { return neighbors.data() + (size_t)city * k; }
+                                                            /// Returns the `k` candidates of a city
+    const double* distances_of(const int city) const { return distances.data() + (size_t)city * k; }
+                                                            /// Returns the distances from a city to its `k` candidates
+};
+
+void build_candidates(const Instance& cities, const int k, const bool quadrant, CandidateList& candidates);
+void reorder_candidates(const std::vector<int>& order, CandidateList& candidates);
@@ -1,27 +1,25 @@
-
 #include "City.h"
 
 /**
  * Initializes `cities` variable.
  * 
  * @param[in, out] cities the random dataset generated for the different TSP approaches
+ * @param[in] n_points the number of cities to generate
+ * @param[in] seed the seed of the run, which determines the dataset (see `Random.h`)
  * 
  * @remark [<random> Engines and Distributions](https:///<docs.microsoft.com/en-us/cpp/standard-library/random?view=msvc-160#engdist) 
  */
-void initialize_cities(std::array<std::pair<int, int>, N_POINTS>& cities)
+void initialize_cities(Instance& cities, const int n_points, const std::uint64_t seed)
 {
-    std::random_device x_rd;                                    /// non-deterministic generator
-    std::mt19937 x_gen(x_rd());                                 /// to seed mersenne twister
+    Xoshiro256 gen = random_stream(seed, STREAM_CITIES);        /// The stream of the dataset
     std::uniform_int_distribution<int> x_dist(0, X_MAX);        /// distribute results between 0 and X_MAX inclusive
-
-    std::random_device y_rd;                                    /// non-deterministic generator
-    std::mt19937 y_gen(y_rd());                                 /// to seed mersenne twister
     std::uniform_int_distribution<int> y_dist(0, Y_MAX);        /// distribute results between 0 and Y_MAX inclusive
 
-    for (int i = 0; i < N_POINTS; i += 1)                       /// Initializes all `N_POINTS`
+    cities.resize(n_points);                                    /// Allocates the coordinate arrays on the heap
+    for (int i = 0; i < n_points; i += 1)                       /// Initializes all `n_points`
     {
-        cities.at(i).first  = x_dist(x_gen);                    /// Generates a random X coordinate for point i
-        cities.at(i).second = y_dist(y_gen);                    /// Generates a random Y coordinate for point i
+        cities.x[i] = x_dist(gen);                              /// Generates a random X coordinate for point i
+        cities.y[i] = y_dist(gen);                              /// Generates a random Y coordinate for point i
     }
 }
 
@@ -30,7 +28,12 @@ void initialize_cities(std::array<std::pair<int, int>, N_POINTS>& cities)
  * 
  * @param[in, out] cities the dataset that is set
  */
-void set_fixed_dataset(std::array<std::pair<int, int>, N_POINTS>& cities)
+void set_fixed_dataset(Instance& cities)
 {
-    std::copy(std::begin(FIXED_DATASET), std::end(FIXED_DATASET), std::begin(cities));
-}
\ No newline at end of file
+    cities.resize(FIXED_POINTS);
+    for (int i = 0; i < FIXED_POINTS; i += 1)
+    {
+        cities.x[i] = FIXED_DATASET.at(i).first;
+        cities.y[i] = FIXED_DATASET.at(i).second;
+    }
+}
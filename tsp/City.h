@@ -1,4 +1,3 @@
-
 /**
  * City.h
  * 
@@ -12,6 +11,8 @@
 #pragma once
 
 #include "Common.h"
+#include "Instance.h"
+#include "Random.h"
 
-void initialize_cities(std::array<std::pair<int, int>, N_POINTS>& cities);
-void set_fixed_dataset(std::array<std::pair<int, int>, N_POINTS>& cities);
+void initialize_cities(Instance& cities, const int n_points, const std::uint64_t seed);
+void set_fixed_dataset(Instance& cities);
@@ -1,67 +1,207 @@
 
 #include "Colonize.h"
 
+/**
+ * Allocates the scratch buffers of an ant.
+ *
+ * @param[in] n_points the number of cities
+ * @param[in] ant_memory the number of cities the ant crosses in each iteration
+ *
+ * @note this is the only place where the memory of an ant is allocated. The buffers are reused 
+ *      by every step of every iteration, so the colonization does not allocate memory at all.
+ */
+Ant::Ant(const int n_points, const int ant_memory) : non_explored(n_points), position(n_points), explored(ant_memory)
+{
+    std::iota(non_explored.begin(), non_explored.end(), 0);
+    std::iota(position.begin(), position.end(), 0);
+    evaluation.reserve(n_points);                                   /// The evaluation of the edges never exceeds the number of cities
+}
+
+/**
+ * Marks a city as explored.
+ *
+ * @param[in] city the city the ant moved to
+ * @param[in] k the number of cities explored before `city`
+ *
+ * @note the city is swapped with the first unexplored city, so that the first `k` + 1 cities
+ *      of `non_explored` are the explored ones. The position index makes the swap O(1).
+ */
+void Ant::visit(const int city, const int k)
+{
+    const int other = non_explored[k];
+    std::swap(non_explored[k], non_explored[position[city]]);
+    position[other] = position[city];
+    position[city] = k;
+}
+
+/**
+ * Keeps a tour if it is the best one of the iteration, and the best one so far.
+ *
+ * @param[in] tour the closed tour, with respect to the cities of the instance
+ * @param[in] cost the cost of `tour`
+ * @param[in] iteration the iteration where `tour` was found
+ *
+ * @return true if `tour` is the best tour so far
+ */
+bool ColonyTours::offer(const std::vector<int>& tour, const double cost, const int iteration)
+{
+    if (cost < iteration_cost)
+    {
+        iteration_best.assign(tour.begin(), tour.end());
+        iteration_cost = cost;
+    }
+    if (cost >= best_cost) { return false; }
+    best.assign(tour.begin(), tour.end());
+    best_cost = cost;
+    best_iteration = iteration;
+    return true;
+}
+
+/**
+ * Keeps the tour of an ant, which must have crossed every city, if it is the best one of the iteration, and the best one so far.
+ *
+ * @param[in] ant the ant, whose `tour_cost` has been computed (see `ant_tour_cost()`)
+ * @param[in] iteration the iteration where the ant crossed the map
+ *
+ * @return true if the tour of the ant is the best tour so far
+ *
+ * @note the tour is only copied out of `ant.explored` if it is kept.
+ */
+bool ColonyTours::offer(const Ant& ant, const int iteration)
+{
+    const double cost = ant.tour_cost;
+    if (cost < iteration_cost)
+    {
+        iteration_best.resize(ant.explored.size());
+        for (size_t k = 0; k < ant.explored.size(); k += 1) { iteration_best[k] = ant.explored[k].first; }
+        iteration_cost = cost;
+    }
+    if (cost >= best_cost) { return false; }
+    best.resize(ant.explored.size());
+    for (size_t k = 0; k < ant.explored.size(); k += 1) { best[k] = ant.explored[k].first; }
+    best_cost = cost;
+    best_iteration = iteration;
+    return true;
+}
+
+/**
+ * Computes the cost of the closed tour of an ant.
+ *
+ * @param[in] ant the ant, which must have crossed every city
+ * @param[in] cities the dataset for ACS
+ *
+ * @return the cost of the tour, including the edge that returns to the first city
+ */
+double ant_tour_cost(const Ant& ant, const Instance& cities)
+{
+    double cost = 0.0;
+    for (size_t k = 0; k + 1 < ant.explored.size(); k += 1)
+    {
+        cost += tsp_hop_cost(cities, ant.explored[k].first, ant.explored[k + 1].first).second;
+    }
+    return cost + tsp_hop_cost(cities, ant.explored.back().first, ant.explored.front().first).second;
+}
+
+/**
+ * Moves an ant to its next city.
+ *
+ * @param[in, out] ant the ant
+ * @param[in] k the number of cities the ant has explored, minus 1
+ * @param[in] cities the dataset for ACS
+ * @param[in] candidates the candidate lists of `cities`
+ * @param[in] pherormone the store with the pherormone ammount left in each edge (see `Pherormone.h`)
+ * @param[in] choice_info the tabulated evaluation of the candidate edges, or nullptr (see `ChoiceInfo` in `Pherormone.h`)
+ * @param[in] selection the method that selects the edge to follow (see `Selection.h`)
+ *
+ * @return the city chosen by the ant, which is also stored in `ant.explored`
+ */
+template <typename Store>
+int ant_step(
+    Ant&                                                ant,
+    const int                                           k,
+    const Instance&                                     cities,
+    const CandidateList&                                candidates,
+    const Store&                                        pherormone,
+    const ChoiceInfo*                                   choice_info,
+    const int                                           selection)
+{
+    const int current = ant.explored[k].first;
+    ant.visit(current, k);                                          /// Places previously added node on the left of index `k` into `non_explored`
+    evaluate_universe(ant.non_explored, ant.position, k, pherormone, choice_info, cities, candidates, ant.evaluation);
+                                                                    /// Evaluates all possible edges
+    const int chosen_idx = select_edge(ant.evaluation, selection, ant.gen);
+                                                                    /// Calls select_edge() to get the chosen edge
+    ant.explored[k + 1] = std::make_pair(chosen_idx, BOOST / tsp_hop_cost(cities, current, chosen_idx).second);
+                                                                    /// Updates `explored` vector
+    return chosen_idx;
+}
+
 /**
  * Initiates colonization sequence.
  * 
  * @param[in] cities the dataset for ACS
- * @param[in, out] pherormone_matrix the matrix (2d array of sizxe `N_POINTS` x `N_POINTS`) with the pherormone ammount left in each edge
+ * @param[in] candidates the candidate lists of `cities` (see `Candidates.h`)
+ * @param[in] settings the run time settings (number of iterations, choice information, selection method and tracking of the best tours)
+ * @param[in, out] pherormone the store with the pherormone ammount left in each edge (see `Pherormone.h`)
+ * @param[in, out] tours the best tours found by the colony
  * 
+ * @note each ant owns its scratch buffers (see `Ant`), which are allocated once. Each step of an
+ *      ant evaluates the unexplored candidates of its city, so it costs O(k) instead of O(n). With
+ *      `settings.choice_info`, the evaluation of the candidate edges is tabulated once per iteration,
+ *      so the ants of an iteration read it as it was at the start of the iteration. The ants only cross
+ *      `ANT_MEMORY` cities, so unless that covers every city, the tour of each iteration is extracted
+ *      from the pherormone store after the iteration (see `acs_tsp()`), which costs O(n * k).
  */
+template <typename Store>
 void colonize(
-    const std::array<std::pair<int, int>, N_POINTS>     cities,
-    std::vector<std::array<double, N_POINTS>>&          pherormone_matrix)
-{
-    std::vector<std::array<int, N_POINTS>> non_explored(N_ANTS);    /// Declares a vector that holds all possible points.
-                                                                    /// This vector is fragmented into an explored part and an non explored part.
-                                                                    /// The explored part is separated by  the non explored part by an index `k`.
-                                                                    /// On the left of `k` lie the explored nodes, and on the right the non explored. 
-                                                                    /// `k` always points to the node where each ant is currently at.
-    std::vector<std::array<std::pair<int, double>, ANT_MEMORY>> explored(N_ANTS);
-                                                                    /// Declares a vector that holds the points that the ant has crossed.
-                                                                    /// This vector has mainly debugging purposes. However, it is not memory demanding.
-
-    std::random_device ant_rd;                                      /// non-deterministic generator
-    std::mt19937 ant_gen(ant_rd());                                 /// to seed mersenne twister
-    std::uniform_int_distribution<int> ant_dist(0, N_POINTS - 1);   /// distribute results between 0 and N_POINTS exclusive
-
-    std::random_device wheel_rd;                                    /// non-deterministic generator
-    std::mt19937 wheel_gen(wheel_rd());                             /// to seed mersenne twister
-    std::uniform_real_distribution<double> wheel_dist(0, 1);        /// distribute results between 0 and 1 inclusive
-
-    for (int i = 0; i < ITERATIONS; i += 1)
-    {
-        std::cout << "Iteration [" << i << "]" << std::endl;        /// Prints progress info of the ACS since it takes some times to colonize the map
-        for (int j = 0; j < N_ANTS; j += 1)
+    const Instance&                                     cities,
+    const CandidateList&                                candidates,
+    const Settings&                                     settings,
+    Store&                                              pherormone,
+    ColonyTours&                                        tours)
+{
+    const int n_points = cities.size();                             /// Fetches the number of cities of the instance
+    const int ant_memory = std::min(ANT_MEMORY, n_points);          /// Clamps the ant memory to the number of cities
+    std::vector<Ant> ants(settings.ants, Ant(n_points, ant_memory));/// Declares the ants along with their scratch buffers
+    for (int j = 0; j < settings.ants; j += 1) { ants[j].gen = random_stream(settings.seed, STREAM_THREADS + j); }
+                                                                    /// Each ant owns a stream (see `Random.h`)
+    Xoshiro256 ant_gen = random_stream(settings.seed, STREAM_MAIN); /// The stream that places the ants
+    std::uniform_int_distribution<int> ant_dist(0, n_points - 1);   /// distribute results between 0 and n_points exclusive
+    std::unique_ptr<ChoiceInfo> choice_info;                        /// Declares the tabulated evaluation of the candidate edges, if requested
+    if (settings.choice_info) { choice_info = std::make_unique<ChoiceInfo>(candidates, n_points); }
+    std::unique_ptr<KdTree> tree;                                   /// Declares the spatial index of the extraction, which is reused by every iteration
+    if (settings.track_best && cities.is_geometric()) { tree = std::make_unique<KdTree>(cities); }
+    std::vector<int> route;                                         /// Declares the tour extracted after each iteration
+    route.reserve(n_points);
+
+    for (int i = 0; i < settings.iterations; i += 1)
+    {
+        if (settings.progress) { std::cout << "Iteration [" << i << "]" << std::endl; }
+                                                                    /// Prints progress info of the ACS since it takes some times to colonize the map
+        tours.begin_iteration();
+        if (choice_info) { choice_info->refresh(pherormone); }      /// Tabulates the evaluation of the candidate edges with the pherormone of this iteration
+        for (int j = 0; j < settings.ants; j += 1)
         {
-            std::iota(non_explored.at(j).begin(), non_explored.at(j).end(), 0);
-                                                                    /// Initializes `non_explored` for the `j`-th ant
-            explored.at(j).at(0) = std::make_pair(ant_dist(ant_gen), 0.0);
-                                                                    /// Initializes `explored` for the `j`-th ant
-            for (int k = 0; k < ANT_MEMORY - 1; k += 1)
+            Ant& ant = ants[j];
+            ant.explored[0] = std::make_pair(ant_dist(ant_gen), 0.0);
+                                                                    /// Places the `j`-th ant in a random city
+            for (int k = 0; k < ant_memory - 1; k += 1)
             {
-                int idx = find(non_explored.at(j), explored.at(j).at(k).first);
-                                                                    /// Locates the index of the previously added node
-                std::swap(non_explored.at(j).at(k), non_explored.at(j).at(idx));
-                                                                    /// Places previously added node on the left of index `k` into `non_explored`
-                std::vector<std::pair<int, double>> evaluation;     /// Declares a vector to store all possible edge evaluations
-                evaluation.reserve(N_POINTS - k);                   /// Reserves the proper memory size to increase performance
-                evaluate_universe(non_explored, j, k, pherormone_matrix, cities, evaluation);
-                                                                    /// Evaluates all possible edges 
-                int chosen_idx = roulette_wheel(evaluation, wheel_dist(wheel_gen));
-                                                                    /// Calls roulette_wheel() to get the chosen edge
-                explored.at(j).at(k + 1) = std::make_pair(chosen_idx, BOOST / tsp_hop_cost(cities.at(explored.at(j).at(k).first), cities.at(chosen_idx)).second);
-                                                                    /// Updates `explored` vector
-                pherormone_matrix.at(explored.at(j).at(k).first).at(explored.at(j).at(k + 1).first) += explored.at(j).at(k + 1).second;
-                                                                    /// Updates pherormone matrix
+                ant_step(ant, k, cities, candidates, pherormone, choice_info.get(), settings.selection);
+                pherormone.deposit(ant.explored[k].first, ant.explored[k + 1].first, ant.explored[k + 1].second);
+                                                                    /// Updates pherormone store
+            }
+            if (ant_memory == n_points)                             /// The ant crossed every city, so its tour is complete
+            {
+                ant.tour_cost = ant_tour_cost(ant, cities);
+                tours.offer(ant, i);
             }
         }
-        for (int j = 0; j < N_POINTS; j += 1)                       /// Vaporization loop
+        pherormone.evaporate();                                     /// Vaporizes pherormone in each edge
+        if (settings.track_best)                                    /// Extracts the tour of the iteration from the pherormone store
         {
-            for (int k = 0; k < N_POINTS; k += 1)
-            {
-                pherormone_matrix.at(j).at(k) = (1 - RHO) * pherormone_matrix.at(j).at(k);
-            }                                                       /// Vaporizes pherormone in each edge
+            acs_tsp(cities, candidates, pherormone, route, tree.get());
+            tours.offer(route, tsp_route_cost(route, cities), i);
         }
     }
 }
@@ -70,88 +210,544 @@ void colonize(
  * Initiates colonization sequence. This is a fork of the `colonize` function above, parallelized with OpenMP 4.0.
  *
  * @param[in] cities the dataset for ACS
- * @param[in, out] pherormone_matrix the matrix (2d array of sizxe `N_POINTS` x `N_POINTS`) with the pherormone ammount left in each edge
+ * @param[in] candidates the candidate lists of `cities` (see `Candidates.h`)
+ * @param[in] settings the run time settings (number of iterations, number of ants, deposit mode, choice information, selection method and tracking of the best tours)
+ * @param[in, out] pherormone the store with the pherormone ammount left in each edge (see `Pherormone.h`)
+ * @param[in, out] tours the best tours found by the colony
  *
+ * @note each ant (thread) works on its own scratch buffers and its own random stream, so the 
+ *      ants only share the pherormone store. With `DEPOSIT_BUFFERED`, the ants do not even write to
+ *      the store while they cross the map. Each ant keeps its deposits in its `explored` vector, and
+ *      the deposits are merged in parallel once all the ants are done (see `merge_deposits()`). Ants
+ *      of the same iteration then do not see the pherormone of each other, as in the Ant System, and
+ *      the run only depends on the seed, regardless of the number of threads and their order.
  */
+template <typename Store>
 void colonize_parallel(
-    const std::array<std::pair<int, int>, N_POINTS>     cities,
-    std::vector<std::array<double, N_POINTS>>&          pherormone_matrix)
+    const Instance&                                     cities,
+    const CandidateList&                                candidates,
+    const Settings&                                     settings,
+    Store&                                              pherormone,
+    ColonyTours&                                        tours)
 {
-    std::array<int, N_POINTS> non_explored;                         /// In the parallel fork, the `non_explored` array is set private for each ant (each ant represents a thread).
-    std::array<std::pair<int, double>, ANT_MEMORY> explored;        /// In the parallel fork, the `explored` array is set private for each ant (each ant represents a thread).
-
-    std::random_device ant_rd;
-    std::mt19937 ant_gen(ant_rd());
-    std::uniform_int_distribution<int> ant_dist(0, N_POINTS - 1);
+    const int n_points = cities.size();
+    const int ant_memory = std::min(ANT_MEMORY, n_points);
+    std::vector<Ant> ants(settings.ants, Ant(n_points, ant_memory));/// In the parallel fork, each ant (each ant represents a thread) owns its buffers
+    for (int j = 0; j < settings.ants; j += 1) { ants[j].gen = random_stream(settings.seed, STREAM_THREADS + j); }
+                                                                    /// and its stream, so the ants never share a generator
+    std::unique_ptr<ChoiceInfo> choice_info;
+    if (settings.choice_info) { choice_info = std::make_unique<ChoiceInfo>(candidates, n_points); }
+    std::unique_ptr<KdTree> tree;
+    if (settings.track_best && cities.is_geometric()) { tree = std::make_unique<KdTree>(cities); }
+    std::vector<int> route;
+    route.reserve(n_points);
 
-    std::random_device wheel_rd;
-    std::mt19937 wheel_gen(wheel_rd());
-    std::uniform_real_distribution<double> wheel_dist(0, 1);
-
-    for (int i = 0; i < ITERATIONS; i += 1)
+    for (int i = 0; i < settings.iterations; i += 1)
     {
-        std::cout << "Iteration [" << i << "]" << std::endl;
-#pragma omp parallel for num_threads(N_ANTS) private(non_explored, explored) schedule(runtime)
-        for (int j = 0; j < N_ANTS; j += 1)
+        if (settings.progress) { std::cout << "Iteration [" << i << "]" << std::endl; }
+        tours.begin_iteration();
+        if (choice_info) { choice_info->refresh_parallel(pherormone); }
+#pragma omp parallel for num_threads(settings.ants) schedule(runtime)
+        for (int j = 0; j < settings.ants; j += 1)
         {
-            std::iota(non_explored.begin(), non_explored.end(), 0);
-            explored.at(0) = std::make_pair(ant_dist(ant_gen), 0.0);
-            for (int k = 0; k < ANT_MEMORY - 1; k += 1)
+            Ant& ant = ants[j];
+            ant.explored[0] = std::make_pair(std::uniform_int_distribution<int>(0, n_points - 1)(ant.gen), 0.0);
+            for (int k = 0; k < ant_memory - 1; k += 1)
             {
-                int idx = find(non_explored, explored.at(k).first);
-                std::swap(non_explored.at(k), non_explored.at(idx));
-                std::vector<std::pair<int, double>> evaluation;
-                evaluation.reserve(N_POINTS - k);
-                evaluate_universe_parallel(non_explored, k, pherormone_matrix, cities, evaluation);
-                int chosen_idx = roulette_wheel(evaluation, wheel_dist(wheel_gen));
-                explored.at(k + 1) = std::make_pair(chosen_idx, BOOST / tsp_hop_cost(cities.at(explored.at(k).first), cities.at(chosen_idx)).second);
+                ant_step(ant, k, cities, candidates, pherormone, choice_info.get(), settings.selection);
+                if (settings.deposit == DEPOSIT_ATOMIC)
+                {
+                    pherormone.deposit_atomic(ant.explored[k].first, ant.explored[k + 1].first, ant.explored[k + 1].second);
+                }
+                else if (settings.deposit == DEPOSIT_CRITICAL)
+                {
 #pragma omp critical
-                pherormone_matrix.at(explored.at(k).first).at(explored.at(k + 1).first) += explored.at(k + 1).second;
+                    pherormone.deposit(ant.explored[k].first, ant.explored[k + 1].first, ant.explored[k + 1].second);
+                }                                                   /// Else the deposits stay buffered in `explored` until all the ants have crossed the map
             }
+            if (ant_memory == n_points) { ant.tour_cost = ant_tour_cost(ant, cities); }
+                                                                    /// Each ant costs its own tour, in parallel
+        }
+        if (settings.deposit == DEPOSIT_BUFFERED) { merge_deposits(ants, settings.ants, pherormone); }
+        pherormone.evaporate_parallel();
+        for (int j = 0; ant_memory == n_points && j < settings.ants; j += 1) { tours.offer(ants[j], i); }
+                                                                    /// The ants are offered in order, so that ties are resolved regardless of the threads
+        if (settings.track_best)
+        {
+            acs_tsp(cities, candidates, pherormone, route, tree.get());
+            tours.offer(route, tsp_route_cost(route, cities), i);
         }
-#pragma omp parallel for collapse(2) schedule(dynamic, CHUNK)
-        for (int j = 0; j < N_POINTS; j += 1)
+    }
+}
+
+/**
+ * Deposits the pherormone buffered by the ants, in parallel and without any lock.
+ *
+ * @param[in] ants the ants, whose `explored` vectors hold the edges they crossed along with the pherormone to deposit
+ * @param[in] n_threads the number of threads
+ * @param[in, out] pherormone the store with the pherormone ammount left in each edge (see `Pherormone.h`)
+ *
+ * @note every thread scans all the buffered deposits, but only applies the ones that fall in its own rows
+ *      of the store (see `row_of()`), so no 2 threads ever write the same value. There are only `ANT_MEMORY`
+ *      deposits per ant, so scanning them is negligible next to the colonization.
+ */
+template <typename Store>
+void merge_deposits(const std::vector<Ant>& ants, const int n_threads, Store& pherormone)
+{
+#pragma omp parallel num_threads(n_threads)
+    {
+        const int thread = omp_get_thread_num();
+        const int n_owners = omp_get_num_threads();
+        for (const Ant& ant : ants)
         {
-            for (int k = 0; k < N_POINTS; k += 1)
+            for (size_t k = 0; k + 1 < ant.explored.size(); k += 1)
             {
-                pherormone_matrix.at(j).at(k) = (1 - RHO) * pherormone_matrix.at(j).at(k);
+                const int a = ant.explored[k].first;
+                const int b = ant.explored[k + 1].first;
+                if (pherormone.row_of(a, b) % n_owners == thread) { pherormone.deposit(a, b, ant.explored[k + 1].second); }
             }
         }
     }
 }
 
 /**
- * Finds TSP route based on pherormone matrix.
+ * Finds TSP route based on pherormone store.
  *
  * This implementation is based on elitism from genetic algorithms.
  * This means that for the released TSP route, only the best solutions
- * based on the `pherormone_matrix` will be concatenated to form the TSP route.
+ * based on the `pherormone` store will be concatenated to form the TSP route.
  * 
- * @param[in] pherormone_matrix the matrix with the pherormone ammount left in each edge
- * @param[in, out] tsp_route the node indexes with respecto to `cities` variable
- * 
- * @remark https://en.cppreference.com/w/cpp/algorithm/iota
- * @remark https://en.cppreference.com/w/cpp/algorithm/transform
- * @remark https://en.cppreference.com/w/cpp/algorithm/sort
- * @remark https://en.cppreference.com/w/cpp/utility/functional/bind
+ * @param[in] cities the dataset for ACS
+ * @param[in] candidates the candidate lists of `cities` (see `Candidates.h`)
+ * @param[in] pherormone the store with the pherormone ammount left in each edge (see `Pherormone.h`)
+ * @param[in, out] tsp_route the node indexes with respecto to `cities` variable, which are cleared first
+ * @param[in, out] tree the spatial index over `cities`, whose erased cities are restored first, or nullptr to build one here
  * 
+ * @note the salesman follows the unexplored candidate edge with the most pherormone, which costs O(k).
+ *      The ants only deposit pherormone on the edges they follow, which are candidate edges unless all
+ *      the candidates have been explored. So, if all the candidates of a city have been explored, the 
+ *      salesman moves to the closest unexplored city, which is found with a k-d tree (see `KdTree.h`) 
+ *      in roughly O(log n), or by scanning all the cities for instances where the metric does not allow 
+ *      a k-d tree. The explored cities are flagged in a bitset, so the flags of 64 cities share a word.
  */
+template <typename Store>
 void acs_tsp(
-    const std::vector<std::array<double, N_POINTS>>     pherormone_matrix,
-    std::vector<int>&                                   tsp_route)
+    const Instance&                                     cities,
+    const CandidateList&                                candidates,
+    const Store&                                        pherormone,
+    std::vector<int>&                                   tsp_route,
+    KdTree*                                             tree)
 {
+    const int n_points = cities.size();
+    std::unique_ptr<KdTree> own_tree;                               /// Declares a spatial index over the cities, unless one was given
+    if (tree != nullptr) { tree->restore(); }
+    else if (cities.is_geometric())
+    {
+        own_tree = std::make_unique<KdTree>(cities);
+        tree = own_tree.get();
+    }
+    std::vector<std::uint64_t> explored(((size_t)n_points + 63) / 64, 0);
+                                                                    /// Declares a bitset to flag the explored cities
+    auto is_explored = [&explored](const int city) { return ((explored[city >> 6] >> (city & 63)) & 1) != 0; };
+    auto explore = [&explored](const int city) { explored[city >> 6] |= (std::uint64_t)1 << (city & 63); };
+    tsp_route.clear();
     tsp_route.emplace_back(0);
-    for (int i = 0; i < N_POINTS - 1; i += 1)
+    explore(0);
+    if (tree) { tree->erase(0); }
+    for (int i = 0; i < n_points - 1; i += 1)
     {
-        std::vector<double> pherormone_column;                      /// Declares a vector to store the a column from `pherormone_matrix` variable
-        std::vector<int> pherormone_idx(N_POINTS);                  /// Declares a vector to be used to associate each value in `pherormone_column` variable with a node
-        std::vector<std::pair<int, double>> roulette(N_POINTS);     /// Declares a vector to bind the vectors above
-        copy(pherormone_matrix, tsp_route.at(i), pherormone_column);/// Calls copy() from Operation.h and copies column of `pherormone_matrix` variable into `pherormone_column`
-        std::iota(pherormone_idx.begin(), pherormone_idx.end(), 0); /// Initializes `pherormone_idx`
-        std::transform(pherormone_idx.begin(), pherormone_idx.end(), pherormone_column.begin(), roulette.begin(), std::bind(f, std::placeholders::_1, std::placeholders::_2));
-                                                                    /// Binds `pherormone_column` and `pherormone_idx` into `roulette`
-        std::sort(roulette.begin(), roulette.end(), sortbysec_dbl); /// Sorts `roulette` vector 
-        filter(roulette, tsp_route);                                /// Filters `roulette` based on the route computed by the i'th iteration in order to avoid selecting a node that has already been explored
-        tsp_route.emplace_back(roulette.back().first);              /// Updates `tsp_route` vector with the selected node
+        const int current = tsp_route[i];
+        const int* neighbors = candidates.neighbors_of(current);
+        int chosen = -1;
+        double chosen_val = -1.0;
+        for (int slot = 0; slot < candidates.k; slot += 1)           /// Selects the unexplored candidate edge with the most pherormone
+        {
+            if (!is_explored(neighbors[slot]) && pherormone.candidate(current, slot) > chosen_val)
+            {
+                chosen = neighbors[slot];
+                chosen_val = pherormone.candidate(current, slot);
+            }
+        }
+        if (chosen < 0 && tree) { chosen = tree->nearest(current); }
+        long double closest = std::numeric_limits<long double>::infinity();
+        for (int j = 0; !tree && chosen_val < 0 && j < n_points; j += 1)
+        {                                                           /// Scans all the cities for the closest unexplored one
+            const long double cost = (is_explored(j) ? closest : tsp_hop_cost(cities, current, j).second);
+            if (cost < closest) { chosen = j; closest = cost; }
+        }
+        tsp_route.emplace_back(chosen);                             /// Updates `tsp_route` vector with the selected node
+        explore(chosen);
+        if (tree) { tree->erase(chosen); }
     }
 }
+
+/**
+ * Moves an ant of the Ant Colony System to its next city, with the pseudo random proportional rule.
+ *
+ * @param[in, out] ant the ant
+ * @param[in] k the number of cities the ant has explored, minus 1
+ * @param[in] cities the dataset for ACS
+ * @param[in] candidates the candidate lists of `cities`
+ * @param[in] pherormone the store with the pherormone ammount left in each edge (see `Pherormone.h`)
+ * @param[in] q0 the probability that the ant follows the best candidate edge instead of spinning the roulette wheel
+ * @param[in, out] tree the spatial index of the ant, where the explored cities are erased, or nullptr
+ *
+ * @return the city chosen by the ant, which is also stored in `ant.explored`
+ *
+ * @note the edges are evaluated as tau * eta^ACS_BETA. If all the candidates of the city have been explored,
+ *      the ant moves to the closest unexplored city, as the extraction of the tour does (see `acs_tsp()`).
+ */
+template <typename Store>
+int system_step(
+    Ant&                                                ant,
+    const int                                           k,
+    const Instance&                                     cities,
+    const CandidateList&                                candidates,
+    const Store&                                        pherormone,
+    const double                                        q0,
+    KdTree*                                             tree)
+{
+    const int current = ant.explored[k].first;
+    ant.visit(current, k);
+    if (tree) { tree->erase(current); }
+    const int* neighbors = candidates.neighbors_of(current);
+    const double* distances = candidates.distances_of(current);
+    ant.evaluation.clear();
+    int chosen = -1;
+    double chosen_val = -1.0;
+    for (int slot = 0; slot < candidates.k; slot += 1)               /// Evaluates the unexplored candidates and finds the best one
+    {
+        if (ant.position[neighbors[slot]] <= k) { continue; }
+        const double value = pherormone.candidate(current, slot) * power(1 / distances[slot], ACS_BETA);
+        ant.evaluation.emplace_back(neighbors[slot], value);
+        if (value > chosen_val)
+        {
+            chosen = neighbors[slot];
+            chosen_val = value;
+        }
+    }
+    std::uniform_real_distribution<double> uniform(0, 1);
+    if (chosen >= 0 && uniform(ant.gen) >= q0) { chosen = select_proportional(ant.evaluation, uniform(ant.gen)); }
+                                                                    /// Explores with probability 1 - `q0`, else exploits the best edge
+    else if (chosen < 0 && tree) { chosen = tree->nearest(current); }
+    else if (chosen < 0)                                            /// Scans the unexplored cities for the closest one
+    {
+        long double closest = std::numeric_limits<long double>::infinity();
+        for (int l = k + 1; l < cities.size(); l += 1)
+        {
+            const long double cost = tsp_hop_cost(cities, current, ant.non_explored[l]).second;
+            if (cost < closest)
+            {
+                chosen = ant.non_explored[l];
+                closest = cost;
+            }
+        }
+    }
+    ant.explored[k + 1] = std::make_pair(chosen, 0.0);
+    return chosen;
+}
+
+/**
+ * Applies the local pherormone update of the Ant Colony System to an edge that an ant has just crossed.
+ *
+ * @param[in, out] pherormone the store with the pherormone ammount left in each edge (see `Pherormone.h`)
+ * @param[in] a the first city of the edge
+ * @param[in] b the second city of the edge
+ * @param[in] tau0 the initial pherormone of every edge
+ *
+ * @note the pherormone of the edge is pulled towards `tau0`, so that the following ants are less likely to
+ *      cross the same edge. Both directions are updated, unless the store keeps them together.
+ */
+template <typename Store>
+void local_update(Store& pherormone, const int a, const int b, const double tau0)
+{
+    pherormone.deposit(a, b, ACS_XI * (tau0 - pherormone.edge(a, b)));
+    if (!Store::symmetric) { pherormone.deposit(b, a, ACS_XI * (tau0 - pherormone.edge(b, a))); }
+}
+
+/**
+ * Applies the global pherormone update of the Ant Colony System to the edges of the best tour so far.
+ *
+ * @param[in, out] pherormone the store with the pherormone ammount left in each edge (see `Pherormone.h`)
+ * @param[in] tour the best tour so far
+ * @param[in] cost the cost of `tour`
+ *
+ * @note only the edges of the tour evaporate and receive pherormone, so the update costs O(n) instead of
+ *      the O(n^2) evaporation of the whole dense store.
+ */
+template <typename Store>
+void global_update(Store& pherormone, const std::vector<int>& tour, const double cost)
+{
+    for (size_t i = 0; i < tour.size(); i += 1)
+    {
+        const int a = tour[i];
+        const int b = tour[(i + 1) % tour.size()];
+        pherormone.deposit(a, b, RHO * (1 / cost - pherormone.edge(a, b)));
+        if (!Store::symmetric) { pherormone.deposit(b, a, RHO * (1 / cost - pherormone.edge(b, a))); }
+    }
+}
+
+/**
+ * Colonizes the map with the Ant Colony System of Dorigo and Gambardella.
+ *
+ * @param[in] cities the dataset for ACS
+ * @param[in] candidates the candidate lists of `cities` (see `Candidates.h`)
+ * @param[in] settings the run time settings (number of iterations, number of ants, seed and `q0`)
+ * @param[in, out] pherormone the store with the pherormone ammount left in each edge (see `Pherormone.h`)
+ * @param[in, out] tours the best tours found by the colony
+ *
+ * @note every edge starts with tau0 = 1 / (n * L), where L is the cost of the tour extracted from the uniform
+ *      store, which is a nearest neighbor tour. In every iteration each ant builds a complete tour. The ants
+ *      move in lockstep: in every step, the ants choose their next city in parallel, as no ant writes to the
+ *      store, and then the local updates are applied in the order of the ants. So the run only depends on
+ *      the seed, regardless of the number of threads. There is one thread per ant, so `--ants` above the
+ *      number of cores oversubscribes the barrier that the threads meet at in every step. Then only the
+ *      best tour so far receives pherormone (see `global_update()`).
+ *
+ * @remark https://ieeexplore.ieee.org/document/585892
+ */
+template <typename Store>
+void colony_system(
+    const Instance&                                     cities,
+    const CandidateList&                                candidates,
+    const Settings&                                     settings,
+    Store&                                              pherormone,
+    ColonyTours&                                        tours)
+{
+    const int n_points = cities.size();
+    std::vector<int> route;
+    acs_tsp(cities, candidates, pherormone, route);                 /// Every edge has the same pherormone, so the salesman follows the nearest candidates
+    const double tau0 = 1 / ((double)n_points * tsp_route_cost(route, cities));
+    pherormone.fill(tau0);
+    std::vector<Ant> ants(settings.ants, Ant(n_points, n_points));  /// Every ant crosses every city
+    std::vector<std::unique_ptr<KdTree>> trees(settings.ants);      /// Every ant owns a spatial index, where the cities it explored are erased
+    for (int j = 0; j < settings.ants; j += 1)
+    {
+        ants[j].gen = random_stream(settings.seed, STREAM_THREADS + j);
+        if (cities.is_geometric()) { trees[j] = std::make_unique<KdTree>(cities); }
+    }
+
+    for (int i = 0; i < settings.iterations; i += 1)
+    {
+        if (settings.progress) { std::cout << "Iteration [" << i << "]" << std::endl; }
+        tours.begin_iteration();
+#pragma omp parallel num_threads(settings.ants)
+        {
+#pragma omp for schedule(static)
+            for (int j = 0; j < settings.ants; j += 1)              /// Places each ant in a random city
+            {
+                ants[j].explored[0] = std::make_pair(std::uniform_int_distribution<int>(0, n_points - 1)(ants[j].gen), 0.0);
+                if (trees[j]) { trees[j]->restore(); }
+            }
+            for (int k = 0; k < n_points - 1; k += 1)
+            {
+#pragma omp for schedule(static)
+                for (int j = 0; j < settings.ants; j += 1)
+                {
+                    system_step(ants[j], k, cities, candidates, pherormone, settings.q0, trees[j].get());
+                }
+#pragma omp single
+                for (int j = 0; j < settings.ants; j += 1)
+                {
+                    local_update(pherormone, ants[j].explored[k].first, ants[j].explored[k + 1].first, tau0);
+                }
+            }
+#pragma omp for schedule(static)
+            for (int j = 0; j < settings.ants; j += 1) { ants[j].tour_cost = ant_tour_cost(ants[j], cities); }
+        }
+        for (int j = 0; j < settings.ants; j += 1)
+        {
+            local_update(pherormone, ants[j].explored.back().first, ants[j].explored.front().first, tau0);
+                                                                    /// Closes the tour of each ant
+            tours.offer(ants[j], i);
+        }
+        global_update(pherormone, tours.best, tours.best_cost);
+    }
+}
+
+/**
+ * Improves the tour of an ant with the local search selected at run time.
+ *
+ * @param[in, out] ant the ant, which must have crossed every city. Its tour in `explored` is replaced by the improved one
+ * @param[in] cities the dataset for ACS
+ * @param[in] candidates the candidate lists of `cities`
+ * @param[in] local_search the local search flags (see `LOCAL_SEARCH_*` in Common.h)
+ */
+void improve_ant_tour(Ant& ant, const Instance& cities, const CandidateList& candidates, const int local_search)
+{
+    std::vector<int> route(ant.explored.size());
+    for (size_t k = 0; k < ant.explored.size(); k += 1) { route[k] = ant.explored[k].first; }
+    Tour tour(route);
+    local_optimum(cities, candidates, local_search, tour);
+    tour.to_route(route);
+    for (size_t k = 0; k < ant.explored.size(); k += 1) { ant.explored[k].first = route[k]; }
+}
+
+/**
+ * Computes the lambda-branching factor of the trails of the candidate edges, which measures the convergence of the MAX - MIN Ant System.
+ *
+ * @param[in] pherormone the store with the pherormone ammount left in each edge (see `Pherormone.h`)
+ * @param[in] candidates the candidate lists of the cities
+ * @param[in] n_points the number of cities
+ *
+ * @return the mean number of candidate edges of a city whose trail exceeds the share `MMAS_LAMBDA` of the
+ *      trail range of the city, divided by 2. It approaches 1 as the trails converge to the 2 tour edges of every city
+ *
+ * @remark https://doi.org/10.1016/S0167-739X(00)00043-1
+ */
+template <typename Store>
+double branching_factor(const Store& pherormone, const CandidateList& candidates, const int n_points)
+{
+    long long branches = 0;
+#pragma omp parallel for reduction(+ : branches) schedule(static)
+    for (int city = 0; city < n_points; city += 1)
+    {
+        double lower = std::numeric_limits<double>::infinity();
+        double upper = -std::numeric_limits<double>::infinity();
+        for (int slot = 0; slot < candidates.k; slot += 1)
+        {
+            lower = std::min(lower, pherormone.candidate(city, slot));
+            upper = std::max(upper, pherormone.candidate(city, slot));
+        }
+        const double cutoff = lower + MMAS_LAMBDA * (upper - lower);
+        for (int slot = 0; slot < candidates.k; slot += 1)
+        {
+            if (pherormone.candidate(city, slot) >= cutoff) { branches += 1; }
+        }
+    }
+    return (double)branches / (2.0 * n_points);
+}
+
+/**
+ * Adds the same pherormone to every edge of a tour.
+ *
+ * @param[in, out] pherormone the store with the pherormone ammount left in each edge (see `Pherormone.h`)
+ * @param[in] tour the closed tour
+ * @param[in] amount the pherormone deposited on each edge
+ */
+template <typename Store>
+void deposit_tour(Store& pherormone, const std::vector<int>& tour, const double amount)
+{
+    for (size_t i = 0; i < tour.size(); i += 1)
+    {
+        const int a = tour[i];
+        const int b = tour[(i + 1) % tour.size()];
+        pherormone.deposit(a, b, amount);
+        if (!Store::symmetric) { pherormone.deposit(b, a, amount); }
+    }
+}
+
+/**
+ * Colonizes the map with the MAX - MIN Ant System of Stutzle and Hoos.
+ *
+ * @param[in] cities the dataset for ACS
+ * @param[in] candidates the candidate lists of `cities` (see `Candidates.h`)
+ * @param[in] settings the run time settings (number of iterations, number of ants, seed and local search)
+ * @param[in, out] pherormone the store with the pherormone ammount left in each edge (see `Pherormone.h`)
+ * @param[in, out] tours the best tours found by the colony
+ *
+ * @note the trails are kept within [tau_min, tau_max], where tau_max = 1 / (RHO * L) for the best tour so far,
+ *      and tau_min is set so that an ant builds the best tour with probability `MMAS_P_BEST` once the trails have
+ *      converged, assuming the ants choose among the `k` candidates of a city. So every edge keeps a chance to be
+ *      followed, and no trail can underflow, even in the `float` and sparse stores. The trails start at tau_max.
+ *      In every iteration, each ant (thread) builds a complete tour with the random proportional rule, since
+ *      no ant writes to the store until all the tours are complete, and improves it with the local search selected
+ *      at run time. Then only the best tour of the iteration deposits pherormone, except for every `MMAS_GLOBAL_PERIOD`
+ *      iterations, where the best tour so far does. When the lambda-branching factor drops below `MMAS_BRANCHING_LIMIT`,
+ *      or no shorter tour has been found for `MMAS_RESTART_LIMIT` iterations, the trails have stagnated, and they are
+ *      reinitialized to tau_max. The bounds are applied lazily by the store (see `clamp()` in `Pherormone.h`).
+ *
+ * @remark https://doi.org/10.1016/S0167-739X(00)00043-1
+ */
+template <typename Store>
+void max_min_system(
+    const Instance&                                     cities,
+    const CandidateList&                                candidates,
+    const Settings&                                     settings,
+    Store&                                              pherormone,
+    ColonyTours&                                        tours)
+{
+    const int n_points = cities.size();
+    double tau_max = 0.0;
+    double tau_min = 0.0;
+    auto set_bounds = [&](const double cost)                        /// Derives the trail bounds from the cost of the best tour so far
+    {
+        const double root = std::pow(MMAS_P_BEST, 1.0 / n_points);
+        tau_max = 1 / (RHO * cost);
+        tau_min = std::min(tau_max, tau_max * (1 - root) / (std::max(1, candidates.k - 1) * root));
+    };
+    std::vector<int> route;
+    acs_tsp(cities, candidates, pherormone, route);                 /// Every edge has the same pherormone, so the salesman follows the nearest candidates
+    set_bounds(tsp_route_cost(route, cities));
+    pherormone.fill(tau_max);
+    std::vector<Ant> ants(settings.ants, Ant(n_points, n_points));
+    std::vector<std::unique_ptr<KdTree>> trees(settings.ants);
+    for (int j = 0; j < settings.ants; j += 1)
+    {
+        ants[j].gen = random_stream(settings.seed, STREAM_THREADS + j);
+        if (cities.is_geometric()) { trees[j] = std::make_unique<KdTree>(cities); }
+    }
+
+    int restart = 0;                                                /// The iteration of the last reinitialization of the trails
+    for (int i = 0; i < settings.iterations; i += 1)
+    {
+        if (settings.progress) { std::cout << "Iteration [" << i << "]" << std::endl; }
+        tours.begin_iteration();
+#pragma omp parallel for num_threads(settings.ants) schedule(static)
+        for (int j = 0; j < settings.ants; j += 1)
+        {
+            Ant& ant = ants[j];
+            ant.explored[0] = std::make_pair(std::uniform_int_distribution<int>(0, n_points - 1)(ant.gen), 0.0);
+            if (trees[j]) { trees[j]->restore(); }
+            for (int k = 0; k < n_points - 1; k += 1)
+            {
+                system_step(ant, k, cities, candidates, pherormone, 0.0, trees[j].get());
+            }
+            if (settings.local_search != 0) { improve_ant_tour(ant, cities, candidates, settings.local_search); }
+            ant.tour_cost = ant_tour_cost(ant, cities);
+        }
+        for (int j = 0; j < settings.ants; j += 1)
+        {
+            if (tours.offer(ants[j], i)) { set_bounds(tours.best_cost); }
+        }
+        pherormone.evaporate_parallel();
+        const bool global = ((i + 1) % MMAS_GLOBAL_PERIOD == 0);
+        deposit_tour(pherormone, (global ? tours.best : tours.iteration_best), 1 / (global ? tours.best_cost : tours.iteration_cost));
+        pherormone.clamp(tau_min, tau_max);
+        if ((i + 1) % MMAS_CHECK_PERIOD == 0 && (i - std::max(restart, tours.best_iteration) >= MMAS_RESTART_LIMIT
+            || branching_factor(pherormone, candidates, n_points) < MMAS_BRANCHING_LIMIT))
+        {
+            pherormone.fill(tau_max);                               /// Reinitializes the trails, while the best tour so far is kept
+            restart = i;
+            if (settings.progress) { std::cout << "Trails reinitialized after iteration [" << i << "]" << std::endl; }
+        }
+    }
+}
+
+template int ant_step<DensePherormone>(Ant&, const int, const Instance&, const CandidateList&, const DensePherormone&, const ChoiceInfo*, const int);
+template int ant_step<SparsePherormone>(Ant&, const int, const Instance&, const CandidateList&, const SparsePherormone&, const ChoiceInfo*, const int);
+template int ant_step<CompactPherormone>(Ant&, const int, const Instance&, const CandidateList&, const CompactPherormone&, const ChoiceInfo*, const int);
+template void acs_tsp<DensePherormone>(const Instance&, const CandidateList&, const DensePherormone&, std::vector<int>&, KdTree*);
+template void acs_tsp<SparsePherormone>(const Instance&, const CandidateList&, const SparsePherormone&, std::vector<int>&, KdTree*);
+template void acs_tsp<CompactPherormone>(const Instance&, const CandidateList&, const CompactPherormone&, std::vector<int>&, KdTree*);
+template void colonize<DensePherormone>(const Instance&, const CandidateList&, const Settings&, DensePherormone&, ColonyTours&);
+template void colonize<SparsePherormone>(const Instance&, const CandidateList&, const Settings&, SparsePherormone&, ColonyTours&);
+template void colonize<CompactPherormone>(const Instance&, const CandidateList&, const Settings&, CompactPherormone&, ColonyTours&);
+template void colonize_parallel<DensePherormone>(const Instance&, const CandidateList&, const Settings&, DensePherormone&, ColonyTours&);
+template void colonize_parallel<SparsePherormone>(const Instance&, const CandidateList&, const Settings&, SparsePherormone&, ColonyTours&);
+template void colonize_parallel<CompactPherormone>(const Instance&, const CandidateList&, const Settings&, CompactPherormone&, ColonyTours&);
+template void merge_deposits<DensePherormone>(const std::vector<Ant>&, const int, DensePherormone&);
+template void merge_deposits<SparsePherormone>(const std::vector<Ant>&, const int, SparsePherormone&);
+template void merge_deposits<CompactPherormone>(const std::vector<Ant>&, const int, CompactPherormone&);
+template int system_step<DensePherormone>(Ant&, const int, const Instance&, const CandidateList&, const DensePherormone&, const double, KdTree*);
+template int system_step<SparsePherormone>(Ant&, const int, const Instance&, const CandidateList&, const SparsePherormone&, const double, KdTree*);
+template int system_step<CompactPherormone>(Ant&, const int, const Instance&, const CandidateList&, const CompactPherormone&, const double, KdTree*);
+template void colony_system<DensePherormone>(const Instance&, const CandidateList&, const Settings&, DensePherormone&, ColonyTours&);
+template void colony_system<SparsePherormone>(const Instance&, const CandidateList&, const Settings&, SparsePherormone&, ColonyTours&);
+template void colony_system<CompactPherormone>(const Instance&, const CandidateList&, const Settings&, CompactPherormone&, ColonyTours&);
+template double branching_factor<DensePherormone>(const DensePherormone&, const CandidateList&, const int);
+template double branching_factor<SparsePherormone>(const SparsePherormone&, const CandidateList&, const int);
+template double branching_factor<CompactPherormone>(const CompactPherormone&, const CandidateList&, const int);
+template void max_min_system<DensePherormone>(const Instance&, const CandidateList&, const Settings&, DensePherormone&, ColonyTours&);
+template void max_min_system<SparsePherormone>(const Instance&, const CandidateList&, const Settings&, SparsePherormone&, ColonyTours&);
+template void max_min_system<CompactPherormone>(const Instance&, const CandidateList&, const Settings&, CompactPherormone&, ColonyTours&);
@@ -6,7 +6,15 @@
  * regarding the ACS algorithm. The functions initiate 
  * the colonization procedure. There is also a function
  * that estimates the total distance covered by the 
- * travelling salesman (`acs_tsp`).
+ * travelling salesman (`acs_tsp`), and the colonization
+ * keeps the best tours found so far (`ColonyTours`). The
+ * Ant Colony System of Dorigo and Gambardella is also here
+ * (`colony_system`), where every ant builds a complete tour,
+ * along with the MAX - MIN Ant System of Stutzle and Hoos
+ * (`max_min_system`), which bounds the trails.
+ * The functions are
+ * templates over the pherormone store (see `Pherormone.h`),
+ * instantiated for every store in `Colonize.cpp`.
  */
 
 #pragma once
@@ -14,8 +22,69 @@
 #include "Naive.h"
 #include "Common.h"
 #include "Distance.h"
+#include "Instance.h"
 #include "Operation.h"
+#include "Candidates.h"
+#include "KdTree.h"
+#include "Pherormone.h"
+#include "Random.h"
+#include "Selection.h"
+#include "Kernel.h"
+#include "LocalSearch.h"
 
-void acs_tsp(const std::vector<std::array<double, N_POINTS>> pherormone_matrix, std::vector<int>& tsp_route);
-void colonize(const std::array<std::pair<int, int>, N_POINTS> cities, std::vector<std::array<double, N_POINTS>>& pherormone_matrix);
-void colonize_parallel(const std::array<std::pair<int, int>, N_POINTS> cities, std::vector<std::array<double, N_POINTS>>& pherormone_matrix);
+/**
+ * The state of an ant, along with the scratch buffers it reuses in every step.
+ */
+struct Ant
+{
+    std::vector<int> non_explored;                          /// The cities, where the first ones are the explored ones (see `colonize()`)
+    std::vector<int> position;                              /// The position of each city inside `non_explored`
+    std::vector<std::pair<int, double>> explored;           /// The cities that the ant has crossed, along with the pherormone it deposited
+    std::vector<std::pair<int, double>> evaluation;         /// The evaluation of the edges the ant may follow
+    Xoshiro256 gen;                                         /// The random stream of the ant (see `Random.h`)
+    double tour_cost = 0.0;                                 /// The cost of the closed tour of the ant, if the ant crossed every city
+
+    Ant(const int n_points, const int ant_memory);
+    void visit(const int city, const int k);
+};
+
+/**
+ * The best tours found by the colony: the best tour of the current iteration and the best tour so far.
+ *
+ * @note the tours are complete, so the answer of the colony is available at any time.
+ */
+struct ColonyTours
+{
+    std::vector<int> best;                                  /// The best tour found so far
+    double best_cost = std::numeric_limits<double>::infinity();
+                                                            /// The cost of the best tour found so far
+    int best_iteration = -1;                                /// The iteration where the best tour was found, or -1 if no tour has been found
+    std::vector<int> iteration_best;                        /// The best tour of the current iteration
+    double iteration_cost = std::numeric_limits<double>::infinity();
+                                                            /// The cost of the best tour of the current iteration
+
+    void begin_iteration() { iteration_cost = std::numeric_limits<double>::infinity(); }
+    bool offer(const std::vector<int>& tour, const double cost, const int iteration);
+    bool offer(const Ant& ant, const int iteration);
+};
+
+double ant_tour_cost(const Ant& ant, const Instance& cities);
+template <typename Store>
+int ant_step(Ant& ant, const int k, const Instance& cities, const CandidateList& candidates, const Store& pherormone, const ChoiceInfo* choice_info, const int selection);
+template <typename Store>
+void acs_tsp(const Instance& cities, const CandidateList& candidates, const Store& pherormone, std::vector<int>& tsp_route, KdTree* tree = nullptr);
+template <typename Store>
+void colonize(const Instance& cities, const CandidateList& candidates, const Settings& settings, Store& pherormone, ColonyTours& tours);
+template <typename Store>
+void merge_deposits(const std::vector<Ant>& ants, const int n_threads, Store& pherormone);
+template <typename Store>
+void colonize_parallel(const Instance& cities, const CandidateList& candidates, const Settings& settings, Store& pherormone, ColonyTours& tours);
+template <typename Store>
+int system_step(Ant& ant, const int k, const Instance& cities, const CandidateList& candidates, const Store& pherormone, const double q0, KdTree* tree);
+template <typename Store>
+void colony_system(const Instance& cities, const CandidateList& candidates, const Settings& settings, Store& pherormone, ColonyTours& tours);
+void improve_ant_tour(Ant& ant, const Instance& cities, const CandidateList& candidates, const int local_search);
+template <typename Store>
+double branching_factor(const Store& pherormone, const CandidateList& candidates, const int n_points);
+template <typename Store>
+void max_min_system(const Instance& cities, const CandidateList& candidates, const Settings& settings, Store& pherormone, ColonyTours& tours);
@@ -11,19 +11,25 @@
 
 #include <array>                                            /// std::array
 #include <cmath>                                            /// std::sqrt
+#include <cstdint>                                          /// std::uint64_t
+#include <deque>                                            /// std::deque
 #include <vector>                                           /// std::vector
 #include <chrono>                                           /// std::chrono
 #include <string>                                           /// std::string
 #include <random>                                           /// std::random_device
 #include <limits>                                           /// std::numeric_limits
 #include <utility>                                          /// std::pair
+#include <tuple>                                            /// std::tuple
 #include <fstream>                                          /// std::ofstream
+#include <memory>                                           /// std::unique_ptr
 #include <numeric>                                          /// std::iota
 #include <iomanip>                                          /// std::setw
 #include <iostream>                                         /// std::cout
 #include <iterator>                                         /// std::<T>::iterator
+#include <stdexcept>                                        /// std::exception
 #include <algorithm>                                        /// std::find
 #include <functional>                                       /// std::bind
+#include <type_traits>                                      /// std::is_same_v
 
 #include <omp.h>                                            /// OpenMP Multiprocessing Programming Framework
 
@@ -40,23 +46,80 @@ constexpr int ALGORITHM = 1;                                /// If 0 then the al
                                                             /// If 4 then the algorithm running is the `TSP with naive nearest neighbor` (Parallel Implementation), as described in `Utilities.cpp`
                                                             /// If 5 then the algorithm running is the `ACS TSP`, as described in `Utilities.cpp`
                                                             /// If 6 then the algorithm running is the `ACS TSP` (Parallel Implementation), as described in `Utilities.cpp`
+                                                            /// If 7 then the algorithm running is the `TSP with Lin - Kernighan`, as described in `Utilities.cpp`
+                                                            /// If 8 then the algorithm running is the `Ant Colony System`, as described in `Utilities.cpp`
+                                                            /// If 9 then the algorithm running is the `MAX - MIN Ant System`, as described in `Utilities.cpp`
+                                                            /// If 10 then the algorithm running is the `TSP with space filling curve`, as described in `Utilities.cpp`
+                                                            /// If 11 then the algorithm running is the `TSP with greedy edge`, as described in `Construction.cpp`
+                                                            /// If 12 then the algorithm running is the `TSP with savings`, as described in `Construction.cpp`
                                                             /// Else no algorithm runs and a warning is displayed
 constexpr int N_THREADS = 12;                               /// This is the number of threads requested in any parallel implementations of the project
 
 constexpr int X_MAX = 1000;                                 /// This is the upper limit of any city's "Longitude". This means that a city can have X coordinates that belong in [0, X_MAX]
 constexpr int Y_MAX = 1000;                                 /// This is the upper limit of any city's "Latitude". This means that a city can have Y coordinates that belong in [0, Y_MAX]
-constexpr int N_POINTS = (                                  /// This variable sets the number of cities. For the ACS implementations, this number must be low, due to memory management issues.
-    TEST_MODE == 1 ? 10   :                                 /// That is mainly due to the pherormone matrix, which is a dense matrix, and cannot be easily factorized to optimize memory management. 
-    ALGORITHM == 5 ? 1000 :
-    ALGORITHM == 6 ? 1000 : 10000);
-constexpr int ITERATIONS = (                                /// This is the number of iterations that any algorithm will execute. The TSP is an NP-complete problem. 
-    TEST_MODE == 1 ? 10     :                               /// Therefore and since the approaches in this project are mainly naive (there is a statistical element, 
-    ALGORITHM == 1 ? 10000  :                               /// such as a random choice between N possible decisions), we set a number of iterations for the algorithm to run.
-    ALGORITHM == 5 ? 100    : 
-    ALGORITHM == 6 ? 100    : 100000000);
+
+/**
+ * Computes the default number of cities for an algorithm. For the ACS implementations, this number is low, so that the default run also
+ * fits the dense pherormone matrix. Larger instances use the sparse pherormone store (see `Pherormone.h`).
+ *
+ * @param[in] algorithm the algorithm identifier (see `ALGORITHM`)
+ *
+ * @return the number of cities used when none is given on the command line
+ */
+constexpr int default_points(const int algorithm)
+{
+    return (TEST_MODE == 1 ? 10   :
+        algorithm == 5     ? 1000 :
+        algorithm == 6     ? 1000 :
+        algorithm == 8     ? 1000 :
+        algorithm == 9     ? 1000 : 10000);
+}
+
+/**
+ * Computes the default number of iterations for an algorithm. The TSP is an NP-complete problem. Therefore and since the approaches 
+ * in this project are mainly naive (there is a statistical element, such as a random choice between N possible decisions), 
+ * we set a number of iterations for the algorithm to run.
+ *
+ * @param[in] algorithm the algorithm identifier (see `ALGORITHM`)
+ *
+ * @return the number of iterations used when none is given on the command line
+ */
+constexpr int default_iterations(const int algorithm)
+{
+    return (TEST_MODE == 1 ? 10     :
+        algorithm == 1     ? 10000  :
+        algorithm == 5     ? 100    :
+        algorithm == 6     ? 100    :
+        algorithm == 8     ? 100    :
+        algorithm == 9     ? 100    :
+        algorithm == 10    ? 1      :
+        algorithm == 11    ? 1      :
+        algorithm == 12    ? 1      : 100000000);
+}
+
+constexpr int N_POINTS = default_points(ALGORITHM);         /// This variable sets the default number of cities. It can be overridden at run time using `--cities`.
+constexpr int ITERATIONS = default_iterations(ALGORITHM);   /// This variable sets the default number of iterations. It can be overridden at run time using `--iterations`.
 constexpr double NAIVE_PROBABILITY = 0.3;                   /// This probability is used in the Naive Heinritz - Hsiao approach of the TSP. This probability means that
                                                             /// there is a 70% chance that the algorithm will choose the nearest point to add to its path, and 30% chance
                                                             /// to choose the second nearest point to add to its path. This variable must never be set above 0.5.
+constexpr int NAIVE_SEGMENTS = N_THREADS;                  /// This is the number of pairs of route segments that the parallel Naive TSP improves independently of each other (see `naive_tsp_parallel`).
+constexpr int KD_BUCKET_SIZE = 8;                           /// This is the maximum number of cities stored in a leaf of the k-d tree (see `KdTree.h`). Smaller buckets mean
+                                                            /// deeper trees, larger buckets mean more distance computations per leaf.
+constexpr int N_CANDIDATES = 8;                             /// This is the default number of candidate neighbors stored for each city (see `Candidates.h`). The ACS, the local 
+                                                            /// search and the nearest neighbor approaches only consider those neighbors, unless all of them have been explored.
+constexpr int LOCAL_SEARCH_2OPT = 1;                        /// This flag selects the 2-opt local search (see `LocalSearch.h`), applied to the TSP route of any algorithm.
+constexpr int LOCAL_SEARCH_OROPT = 2;                       /// This flag selects the Or-opt local search (see `LocalSearch.h`), applied after the 2-opt local search if both are selected.
+constexpr int OR_OPT_SEGMENT = 3;                           /// This is the maximum number of consecutive cities moved by an Or-opt move.
+constexpr int TWO_LEVEL_THRESHOLD = 50000;                  /// This is the number of cities from which the local search stores the route as a two-level list instead of an array (see `Tour.h`).
+constexpr int LK_DEPTH = 5;                                 /// This is the maximum number of flips of a Lin - Kernighan move (see `LinKernighan.h`).
+constexpr std::array<int, 2> LK_BREADTH = { 5, 3 };         /// These are the numbers of alternatives tried at the first levels of a Lin - Kernighan move. Deeper levels try 1.
+constexpr int LK_MAX_CANDIDATES = 16;                       /// This is the maximum number of candidates of a city examined at each level of a Lin - Kernighan move.
+constexpr int KICK_SEGMENT = 50;                            /// This is the maximum number of cities of each segment swapped by a double bridge kick.
+constexpr double TIME_LIMIT = 10.0;                         /// This is the default time budget in seconds of the Lin - Kernighan algorithm. It can be overridden at run time using `--time-limit`.
+constexpr int LOCAL_SEARCH = 0;                             /// This variable sets the default local search, as a combination of the flags above. 0 means no local search.
+constexpr bool PARALLEL_LOCAL_SEARCH = false;               /// This flag selects the parallel local search, which evaluates the moves with `N_THREADS` threads and applies them in batches (see `LocalSearch.h`).
+constexpr bool HILBERT_RENUMBER = false;                    /// This flag renumbers the cities along a Hilbert curve before any algorithm runs, so that close cities are also close in memory (see `Hilbert.h`).
+constexpr int HILBERT_ORDER = 16;                           /// This is the order of the Hilbert curve, which covers a 2^`HILBERT_ORDER` x 2^`HILBERT_ORDER` grid over the cities.
 
 constexpr int BOOST = 10;                                   /// This variable boosts the ammount of pherormone added to the edge chosen by the ant. 
                                                             /// This makes ACS convergence better, regarding time complexity.
@@ -65,15 +128,67 @@ constexpr int N_ANTS = 12;                                  /// This is the ammo
 constexpr int ANT_MEMORY = (TEST_MODE == 1 ? 5 : 100);      /// This sets the ant memory. This means that each ant gets to cross 100 points, and since each ant starts 
                                                             /// from a different point of the map, there is a pretty high probability that the ants will cover all the 
                                                             /// map by the end of the algorithm. That is if `N_ANTS` multiplied by `ANT_MEMORY` is greater than `N_POINTS`. 
-                                                            /// Finally, this variable must always be greater than `N_POINTS`.
+                                                            /// Finally, this variable is clamped at run time to the number of cities of the instance.
 constexpr int ROULETTE_SIZE = (TEST_MODE == 1 ? 3 : 4);     /// This the size of the roulette wheel. The roulette wheel is a decision making module that is used in the 
                                                             /// ACS algorithm. This is to solve the computational error that surfaces due to the huge number of possible 
                                                             /// paths the ant can follow. This variable must be changed with respect to the total number of points and to the 
                                                             /// size of the ant memory. The math for this variable is that is has to be less than `N_POINTS` minus `ANT_MEMORY`.
+constexpr int SELECTION_SORT = 0;                           /// This flag selects the original roulette wheel, which sorts all the evaluations of an ant step (see `Naive.h`).
+constexpr int SELECTION_TOP_K = 1;                          /// This flag selects the roulette wheel over the `ROULETTE_SIZE` best evaluations, partitioned in O(n) (see `Selection.h`).
+constexpr int SELECTION_PROPORTIONAL = 2;                   /// This flag selects the roulette wheel over all the evaluations, in O(n).
+constexpr int SELECTION_TOURNAMENT = 3;                     /// This flag selects the best of `ROULETTE_SIZE` evaluations drawn at random, in O(1).
+constexpr int SELECTION = SELECTION_SORT;                   /// This variable sets the selection method of the ants of the ACS.
+constexpr double ACS_Q0 = 0.9;                              /// This is the probability that an ant of the Ant Colony System follows the best edge instead of spinning the roulette wheel.
+constexpr double ACS_XI = 0.1;                              /// This is the ratio of the local pherormone update of the Ant Colony System, which pulls an edge back to the initial pherormone as soon as an ant crosses it.
+constexpr int ACS_BETA = 2;                                 /// This is the exponent of the inverse distance in the attractiveness of an edge for the Ant Colony System.
+constexpr double MMAS_P_BEST = 0.05;                        /// This is the probability that an ant of the MAX - MIN Ant System builds the best tour once the trails have converged, which sets the lower trail bound.
+constexpr double MMAS_LAMBDA = 0.05;                        /// This is the share of the trail range above which the candidate edges of a city count in the lambda-branching factor of the MAX - MIN Ant System.
+constexpr double MMAS_BRANCHING_LIMIT = 1.05;               /// This is the lambda-branching factor below which the trails of the MAX - MIN Ant System have stagnated and are reinitialized. It is 1 once every city only keeps the 2 edges of a tour.
+constexpr int MMAS_CHECK_PERIOD = 10;                       /// This is the number of iterations between 2 stagnation checks of the MAX - MIN Ant System.
+constexpr int MMAS_RESTART_LIMIT = 250;                     /// This is the number of iterations without a shorter tour after which the trails of the MAX - MIN Ant System are reinitialized, even if the lambda-branching factor stays above `MMAS_BRANCHING_LIMIT`.
+constexpr int MMAS_GLOBAL_PERIOD = 25;                      /// This is the number of iterations between 2 deposits of the best tour so far in the MAX - MIN Ant System. The other iterations deposit their best tour.
 constexpr double RHO = 0.1;                                 /// This is the vaporazation ratio for the ACS.
-constexpr int CHUNK = (int)(4 * (N_POINTS / N_ANTS)) + 1;   /// Sets chunk size for OpenMP loop
+constexpr double EVAPORATION_FLOOR = 1e-20;                 /// This is the pending evaporation below which the pherormone stores are normalized, before the `float` values of the compact store come close to overflow.
+constexpr int PHERORMONE_AUTO = 0;                          /// This flag selects the dense pherormone store for instances of up to `DENSE_PHERORMONE_LIMIT` cities, else the sparse one.
+constexpr int PHERORMONE_DENSE = 1;                         /// This flag selects the dense pherormone store, which holds every edge (see `Pherormone.h`).
+constexpr int PHERORMONE_SPARSE = 2;                        /// This flag selects the sparse pherormone store, which only holds the candidate edges (see `Pherormone.h`).
+constexpr int PHERORMONE_COMPACT = 3;                       /// This flag selects the compact pherormone store, which holds every edge once as a `float` (see `Pherormone.h`).
+constexpr int PHERORMONE_STORE = PHERORMONE_AUTO;           /// This variable sets the default pherormone store. It can be overridden at run time using `--pherormone`.
+constexpr int DENSE_PHERORMONE_LIMIT = 5000;                /// This is the maximum number of cities for which the automatic selection uses the dense pherormone store.
+                                                            /// The dense store of 5,000 cities takes 200 MB, and it grows quadratically.
+constexpr int DEPOSIT_CRITICAL = 0;                         /// This flag makes the ants of the parallel ACS deposit pherormone inside a critical section, one edge at a time.
+constexpr int DEPOSIT_ATOMIC = 1;                           /// This flag makes the ants of the parallel ACS deposit pherormone with an atomic addition, one edge at a time.
+constexpr int DEPOSIT_BUFFERED = 2;                         /// This flag makes the ants of the parallel ACS deposit pherormone once all of them have crossed the map, 
+                                                            /// where each thread merges the deposits of its own rows of the pherormone store.
+constexpr int DEPOSIT_MODE = DEPOSIT_BUFFERED;              /// This variable sets the default deposit mode of the parallel ACS. It can be overridden at run time using `--deposit`.
+constexpr int PHERORMONE_ALIGNMENT = 64;                    /// This is the alignment in bytes of the rows of the compact pherormone store, which is the size of a cache line.
+constexpr bool HUGE_PAGES = true;                           /// If true, the compact pherormone store asks the kernel to back it with huge pages. It can be overridden at run time using `--huge-pages`.
+constexpr int ALPHA = 1;                                    /// This is the exponent of the pherormone in the attractiveness of an edge for the ACS (see `Kernel.h`).
+constexpr int BETA = 1;                                     /// This is the exponent of the inverse distance in the attractiveness of an edge for the ACS (see `Kernel.h`).
+constexpr int EVALUATION_BLOCK = 64;                        /// This is the number of edges evaluated by each call of the vectorized kernels of the ACS.
+constexpr int SIMD_AUTO = -1;                               /// This flag selects the widest instruction set supported by the processor for the vectorized kernels.
+constexpr int SIMD_SCALAR = 0;                              /// This flag selects the scalar kernels.
+constexpr int SIMD_AVX2 = 1;                                /// This flag selects the AVX2 kernels, which evaluate 4 edges per instruction.
+constexpr int SIMD_AVX512 = 2;                              /// This flag selects the AVX-512 kernels, which evaluate 8 edges per instruction.
+constexpr bool TRACK_BEST = false;                          /// This flag makes the ACS extract and cost a tour after every iteration, and release the best one (see `ColonyTours` in `Colonize.h`).
+constexpr bool CHOICE_INFO = false;                         /// This flag makes the ants of the ACS read the attractiveness of the candidate edges from a table refreshed once per iteration (see `ChoiceInfo` in `Pherormone.h`).
+constexpr long long SEED = -1;                              /// This variable sets the seed of every random choice of a run (see `Random.h`). If negative, a random seed is drawn 
+                                                            /// and printed, so that the run can be repeated. It can be overridden at run time using `--seed`.
+constexpr int BENCHMARK_ITERATIONS = 10;                    /// This is the number of iterations of each run of the benchmarks (see `Benchmark.h`).
+constexpr int BENCHMARK_MAX_THREADS = 64;                   /// This is the maximum number of threads of the benchmarks, which double the number of threads from 1 up to it.
 
-constexpr std::array<std::pair<int, int>, N_POINTS> FIXED_DATASET = {
+/**
+ * Computes the chunk size for OpenMP loops that sweep over the cities.
+ *
+ * @param[in] n_points the number of cities of the instance
+ *
+ * @return the chunk size
+ */
+constexpr int chunk_size(const int n_points) { return (int)(4 * (n_points / N_ANTS)) + 1; }
+
+constexpr int FIXED_POINTS = 10;                            /// This is the number of cities in the fixed dataset below
+
+constexpr std::array<std::pair<int, int>, FIXED_POINTS> FIXED_DATASET = {
     std::make_pair(42, 53),
     std::make_pair(364, 45),
     std::make_pair(84, 212),
@@ -86,3 +201,39 @@ constexpr std::array<std::pair<int, int>, N_POINTS> FIXED_DATASET = {
     std::make_pair(263, 631)
 };                                                          /// This vector is the initializer of the dataset if 
                                                             /// the programmer wishes to compare the TSP approaches with a fixed dataset
+
+/**
+ * Holds the run time settings of the project.
+ *
+ * Every member defaults to the compile time constants above, so that
+ * the executable behaves exactly as configured in this file when no 
+ * command line arguments are given. The command line parser in 
+ * `Interface.cpp` overrides them.
+ */
+struct Settings
+{
+    int algorithm = ALGORITHM;                              /// The algorithm to execute (see `ALGORITHM`)
+    int n_points = -1;                                      /// The number of cities to generate. If negative, `default_points(algorithm)` is used
+    int iterations = -1;                                    /// The number of iterations to execute. If negative, `default_iterations(algorithm)` is used
+    std::string input;                                      /// The TSPLIB instance (`.tsp` file) to solve. If empty, a random instance of `n_points` cities is generated
+    std::string tour_output;                                /// The TSPLIB tour (`.tour` file) where the computed tour is exported. If empty, the tour is not exported
+    std::string optimal_tour;                               /// The TSPLIB tour (`.tour` file) of a known optimum to compare the computed tour with. If empty, no comparison is made
+    int candidates = N_CANDIDATES;                          /// The number of candidate neighbors of each city
+    bool quadrant_candidates = false;                       /// If true, the candidate neighbors are balanced between the 4 quadrants around each city, else they are the nearest cities
+    int local_search = LOCAL_SEARCH;                        /// The local search applied to the TSP route, as a combination of the `LOCAL_SEARCH_*` flags
+    bool parallel_local_search = PARALLEL_LOCAL_SEARCH;     /// If true, the moves of the local search are evaluated in parallel and applied in batches
+    bool renumber = HILBERT_RENUMBER;                       /// If true, the cities are renumbered along a Hilbert curve before the algorithm runs
+    double time_limit = TIME_LIMIT;                         /// The time budget in seconds of the algorithms that improve the route until they run out of time
+    int pherormone = PHERORMONE_STORE;                      /// The pherormone store of the ACS (see `PHERORMONE_*`)
+    int ants = N_ANTS;                                      /// The number of ants of the ACS, which is also the number of threads of the parallel ACS
+    int deposit = DEPOSIT_MODE;                             /// The deposit mode of the parallel ACS (see `DEPOSIT_*`)
+    std::string benchmark;                                  /// The benchmark to execute instead of an algorithm (see `Benchmark.h`). If empty, the algorithm is executed
+    bool progress = true;                                   /// If true, the iterative algorithms print their progress
+    bool track_best = TRACK_BEST;                           /// If true, the ACS keeps the best tour of every iteration and releases the best one so far
+    double q0 = ACS_Q0;                                     /// The exploitation probability of the Ant Colony System
+    int selection = SELECTION;                              /// The selection method of the ants (see `SELECTION_*`)
+    bool choice_info = CHOICE_INFO;                         /// If true, the attractiveness of the candidate edges is tabulated once per iteration of the ACS
+    int simd = SIMD_AUTO;                                   /// The instruction set of the vectorized kernels (see `SIMD_*`). It is clamped to the instruction sets of the processor
+    long long seed = SEED;                                  /// The seed of the random generators. If negative, a random seed is drawn
+    bool huge_pages = HUGE_PAGES;                           /// If true, the compact pherormone store is backed by huge pages where the platform supports them
+};
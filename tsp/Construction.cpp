@@ -0,0 +1,239 @@
+#include "Construction.h"
+#include "Utilities.h"
+
+/**
+ * Creates a set for every city.
+ *
+ * @param[in] n_points the number of cities
+ */
+DisjointSets::DisjointSets(const int n_points) : parent(n_points), size(n_points, 1)
+{
+    std::iota(parent.begin(), parent.end(), 0);
+}
+
+/**
+ * Finds the set of a city.
+ *
+ * @param[in] city the city
+ *
+ * @return the root of the set of `city`
+ */
+int DisjointSets::find(int city)
+{
+    while (parent[city] != city)
+    {
+        parent[city] = parent[parent[city]];                /// Halve the path to the root
+        city = parent[city];
+    }
+    return city;
+}
+
+/**
+ * Merges the sets of 2 cities.
+ *
+ * @param[in] a the first city
+ * @param[in] b the second city
+ *
+ * @return false if the cities were already in the same set, else true
+ */
+bool DisjointSets::unite(const int a, const int b)
+{
+    int root_a = find(a);
+    int root_b = find(b);
+    if (root_a == root_b) { return false; }
+    if (size[root_a] < size[root_b]) { std::swap(root_a, root_b); }
+    parent[root_b] = root_a;                                /// Attach the smaller set under the larger one
+    size[root_a] += size[root_b];
+    return true;
+}
+
+/**
+ * Adds the edges to the route in the given order, as long as they keep the route a set of paths.
+ *
+ * @param[in] n_points the number of cities
+ * @param[in] edges the candidate edges (key, a, b), sorted in the order they are to be added
+ * @param[out] adjacent the (up to) 2 cities connected to each city, or -1
+ */
+void match_edges(const int n_points, const std::vector<std::tuple<double, int, int>>& edges, std::vector<std::array<int, 2>>& adjacent)
+{
+    adjacent.assign(n_points, { -1, -1 });
+    DisjointSets fragments(n_points);
+    int n_edges = 0;
+    for (const std::tuple<double, int, int>& edge : edges)
+    {
+        const int a = std::get<1>(edge);
+        const int b = std::get<2>(edge);
+        if (adjacent[a][1] != -1 || adjacent[b][1] != -1) { continue; }
+                                                            /// A city of the route has 2 edges at most
+        if (!fragments.unite(a, b)) { continue; }           /// The edge would close a cycle
+        adjacent[a][adjacent[a][0] == -1 ? 0 : 1] = b;
+        adjacent[b][adjacent[b][0] == -1 ? 0 : 1] = a;
+        n_edges += 1;
+        if (n_edges == n_points - 1) { break; }             /// The route is a single path
+    }
+}
+
+/**
+ * Joins the paths of the route into a TSP route.
+ *
+ * @param[in] cities the dataset
+ * @param[in] candidates the candidate lists of `cities` (see `Candidates.h`)
+ * @param[in] adjacent the (up to) 2 cities connected to each city, or -1
+ * @param[out] tsp_route the TSP route found
+ *
+ * @remark Path joining:
+ *      - Start at the end of a path
+ *      - Repeat:
+ *      -   Follow the path to its other end
+ *      -   Go to the closest end of a path that has not been followed
+ *      - Until every path has been followed
+ *
+ * @note the cities inside the paths are marked as explored, so the closest end is the closest
+ *      unexplored city, which `closest_unexplored()` finds in the candidate list or in the k-d tree.
+ */
+void join_paths(const Instance& cities, const CandidateList& candidates, const std::vector<std::array<int, 2>>& adjacent, std::vector<int>& tsp_route)
+{
+    const int n_points = cities.size();
+    tsp_route.clear();
+    tsp_route.reserve(n_points);
+    std::unique_ptr<KdTree> tree;
+    if (cities.is_geometric()) { tree = std::make_unique<KdTree>(cities); }
+    std::vector<char> explored(n_points, 0);
+    auto explore = [&](const int city)
+    {
+        explored[city] = 1;
+        if (tree) { tree->erase(city); }
+    };
+    int start = -1;
+    for (int city = 0; city < n_points; city += 1)
+    {
+        if (adjacent[city][1] != -1) { explore(city); }     /// Only the ends of the paths remain unexplored
+        else if (start == -1) { start = city; }
+    }
+    while (start != -1)
+    {
+        int previous = -1;
+        int city = start;
+        explore(start);
+        while (true)                                        /// Follow the path to its other end
+        {
+            tsp_route.push_back(city);
+            const int next = (adjacent[city][0] != previous ? adjacent[city][0] : adjacent[city][1]);
+            if (next == -1 || next == previous) { break; }
+            previous = city;
+            city = next;
+        }
+        if (city != start) { explore(city); }
+        start = ((int)tsp_route.size() < n_points ? closest_unexplored(cities, candidates, tree.get(), explored, city, 1).at(0) : -1);
+    }
+}
+
+/**
+ * Implements TSP with the greedy edge heuristic.
+ *
+ * @param[in] cities the dataset
+ * @param[in] candidates the candidate lists of `cities` (see `Candidates.h`)
+ * @param[out] tsp_route the TSP route found
+ *
+ * @remark Greedy edge:
+ *      - Sort the candidate edges from the shortest to the longest
+ *      - For each edge:
+ *      -   Add it to the route, unless one of its cities already has 2 edges or it closes a cycle
+ *      - Join the paths that remain into a route
+ *
+ * @note every candidate edge appears twice if each of its cities is a candidate of the other,
+ *      and only one copy is kept. Equal edges are sorted by their cities, so the route is the
+ *      same on every run.
+ */
+void greedy_edge(const Instance& cities, const CandidateList& candidates, std::vector<int>& tsp_route)
+{
+    const int n_points = cities.size();
+    std::vector<std::tuple<double, int, int>> edges;
+    edges.reserve((size_t)n_points * candidates.k);
+    for (int a = 0; a < n_points; a += 1)
+    {
+        const int* neighbors = candidates.neighbors_of(a);
+        const double* distances = candidates.distances_of(a);
+        for (int j = 0; j < candidates.k; j += 1)
+        {
+            edges.emplace_back(distances[j], std::min(a, neighbors[j]), std::max(a, neighbors[j]));
+        }
+    }
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+    std::vector<std::array<int, 2>> adjacent;
+    match_edges(n_points, edges, adjacent);
+    join_paths(cities, candidates, adjacent, tsp_route);
+    if (TEST_MODE)
+    {
+        export_acs_tsp_route(cities, "greedy_edge", tsp_route);
+    }
+}
+
+/**
+ * Implements TSP with the savings heuristic of Clarke and Wright.
+ *
+ * @param[in] cities the dataset
+ * @param[in] candidates the candidate lists of `cities` (see `Candidates.h`)
+ * @param[out] tsp_route the TSP route found
+ *
+ * @remark Savings:
+ *      - Pick the city closest to the center of the cities as the hub
+ *      - For each candidate edge (a, b) that does not touch the hub, compute its saving
+ *      -   d(hub, a) + d(hub, b) - d(a, b) over the detour a -> hub -> b
+ *      - Sort the edges from the largest saving to the smallest
+ *      - For each edge:
+ *      -   Add it to the route, unless one of its cities already has 2 edges or it closes a cycle
+ *      - Join the paths that remain (and the hub) into a route
+ *
+ * @note the original heuristic only considers the pairs of cities, which costs O(n^2 log n).
+ *      Only the candidate edges are considered here, so some paths may remain at the end,
+ *      and they are joined like the paths of the greedy edge heuristic. If the metric is not
+ *      geometric, the hub is the first city.
+ */
+void savings(const Instance& cities, const CandidateList& candidates, std::vector<int>& tsp_route)
+{
+    const int n_points = cities.size();
+    int hub = 0;
+    if (cities.is_geometric())
+    {
+        const double center_x = std::accumulate(cities.x.begin(), cities.x.end(), 0.0) / n_points;
+        const double center_y = std::accumulate(cities.y.begin(), cities.y.end(), 0.0) / n_points;
+        double closest = std::numeric_limits<double>::infinity();
+        for (int city = 0; city < n_points; city += 1)
+        {
+            const double dx = cities.x[city] - center_x;
+            const double dy = cities.y[city] - center_y;
+            if (dx * dx + dy * dy < closest) { closest = dx * dx + dy * dy; hub = city; }
+        }
+    }
+    std::vector<double> to_hub(n_points);                   /// Declare a vector to store the distance of every city to the hub
+#pragma omp parallel for schedule(static)
+    for (int city = 0; city < n_points; city += 1)
+    {
+        to_hub[city] = (double)tsp_hop_cost(cities, hub, city).second;
+    }
+    std::vector<std::tuple<double, int, int>> edges;
+    edges.reserve((size_t)n_points * candidates.k);
+    for (int a = 0; a < n_points; a += 1)
+    {
+        if (a == hub) { continue; }
+        const int* neighbors = candidates.neighbors_of(a);
+        const double* distances = candidates.distances_of(a);
+        for (int j = 0; j < candidates.k; j += 1)
+        {
+            const int b = neighbors[j];
+            if (b == hub) { continue; }
+            edges.emplace_back(distances[j] - to_hub[a] - to_hub[b], std::min(a, b), std::max(a, b));
+        }                                                   /// The negated saving, so that the largest saving is sorted first
+    }
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+    std::vector<std::array<int, 2>> adjacent;
+    match_edges(n_points, edges, adjacent);
+    join_paths(cities, candidates, adjacent, tsp_route);
+    if (TEST_MODE)
+    {
+        export_acs_tsp_route(cities, "savings", tsp_route);
+    }
+}
@@ -0,0 +1,51 @@
+/**
+ * Construction.h
+ *
+ * In this header file, we define the construction heuristics
+ * that build a TSP route from the candidate graph (see
+ * `Candidates.h`), as a starting route for the local search.
+ * Both of them add the edges of the candidate graph to the
+ * route in a fixed order, as long as every city keeps at
+ * most 2 edges and no edge closes a cycle (which a union -
+ * find detects in nearly O(1)). The paths that remain are
+ * then joined, from the end of each path to the closest end
+ * of another path. The order of the edges is:
+ *  - greedy edge: the shortest edges first
+ *  - savings (Clarke - Wright): the edges that save the most
+ *    over a detour through a central hub city first
+ * Sorting the O(n k) candidate edges costs O(n log n), and
+ * the paths are joined with the k-d tree in O(n log n).
+ *
+ * @remark https://www.cs.ubc.ca/~hutter/previous-earg/EmpAlgReadingGroup/TSP-JohMcg97.pdf
+ * @remark https://doi.org/10.1287/opre.12.4.568
+ */
+
+#pragma once
+
+#include "Common.h"
+#include "Distance.h"
+#include "Instance.h"
+#include "Candidates.h"
+#include "KdTree.h"
+
+/**
+ * The disjoint sets of the cities that are connected by the edges added so far.
+ *
+ * @note the sets are merged by size and the paths to the roots are halved on every
+ *      lookup, so a sequence of operations costs nearly O(1) per operation.
+ */
+class DisjointSets
+{
+public:
+    explicit DisjointSets(const int n_points);
+
+    int find(int city);
+    bool unite(const int a, const int b);
+
+private:
+    std::vector<int> parent;                                /// The parent of each city, which is the city itself for a root
+    std::vector<int> size;                                  /// The number of cities of each set, valid for the roots only
+};
+
+void greedy_edge(const Instance& cities, const CandidateList& candidates, std::vector<int>& tsp_route);
+void savings(const Instance& cities, const CandidateList& candidates, std::vector<int>& tsp_route);
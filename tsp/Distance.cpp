@@ -1,20 +1,77 @@
 
 #include "Distance.h"
+#include "Candidates.h"
+#include "Kernel.h"
+#include "Pherormone.h"
 
 /**
- * Computes the Euclidean distance of 2 given points.
+ * Converts a TSPLIB `GEO` coordinate (DDD.MM format) to radians.
  * 
- * @param[in] point_one this is the first point
- * @param[in] point_two this is the second point
+ * @param[in] coordinate the coordinate, where the integer part holds the degrees and the fractional part the minutes
  * 
- * @return std::pair<int, double> where the integer is an possible overflow warning flag, and the double value is the Euclidean distance
+ * @return the coordinate in radians
+ * 
+ * @note the degrees are truncated (not rounded) to match the published optimal tours.
+ */
+double geo_radians(const double coordinate)
+{
+    const double pi = 3.141592;                             /// TSPLIB fixes the value of pi to 6 decimal digits
+    const int degrees = (int)coordinate;
+    const double minutes = coordinate - degrees;
+    return pi * (degrees + 5.0 * minutes / 3.0) / 180.0;
+}
+
+/**
+ * Computes the distance of 2 given points with respect to the metric of the instance.
+ * 
+ * @param[in] cities the dataset that holds the coordinates of the points
+ * @param[in] point_one this is the index of the first point
+ * @param[in] point_two this is the index of the second point
+ * 
+ * @return std::pair<int, double> where the integer is an possible overflow warning flag, and the double value is the distance
+ * 
+ * @note for the randomly generated datasets this is the Euclidean distance. For the
+ *      TSPLIB datasets the rounding rules of TSPLIB are followed, so that the cost of
+ *      a tour can be compared with the published optimal tours.
+ * 
+ * @remark http://comopt.ifi.uni-heidelberg.de/software/TSPLIB95/tsp95.pdf
  */
-std::pair<int, long double> tsp_hop_cost(const std::pair<int, int> point_one, const std::pair<int, int> point_two)
+std::pair<int, long double> tsp_hop_cost(const Instance& cities, const int point_one, const int point_two)
 {
     std::pair<int, long double> diff;                       /// Declare the return variable
-    diff.second = sqrt(((point_one.first - point_two.first) * (point_one.first - point_two.first)) +
-        ((point_one.second - point_two.second) * (point_one.second - point_two.second)));
-                                                            /// Compute Euclidean distance
+    const double dx = cities.x[point_one] - cities.x[point_two];
+    const double dy = cities.y[point_one] - cities.y[point_two];
+    switch (cities.metric)
+    {
+        case Metric::EUCLIDEAN:
+            diff.second = std::sqrt(dx * dx + dy * dy);     /// Compute Euclidean distance
+            break;
+        case Metric::EUC_2D:
+            diff.second = (int)(std::sqrt(dx * dx + dy * dy) + 0.5);
+            break;
+        case Metric::CEIL_2D:
+            diff.second = std::ceil(std::sqrt(dx * dx + dy * dy));
+            break;
+        case Metric::ATT:
+        {
+            const double r = std::sqrt((dx * dx + dy * dy) / 10.0);
+            const int t = (int)(r + 0.5);
+            diff.second = (t < r ? t + 1 : t);
+            break;
+        }
+        case Metric::GEO:
+        {
+            const double radius = 6378.388;                 /// The radius of the earth according to TSPLIB
+            const double q1 = std::cos(geo_radians(cities.y[point_one]) - geo_radians(cities.y[point_two]));
+            const double q2 = std::cos(geo_radians(cities.x[point_one]) - geo_radians(cities.x[point_two]));
+            const double q3 = std::cos(geo_radians(cities.x[point_one]) + geo_radians(cities.x[point_two]));
+            diff.second = (point_one == point_two ? 0 : (int)(radius * std::acos(0.5 * ((1.0 + q1) * q2 - (1.0 - q1) * q3)) + 1.0));
+            break;
+        }
+        case Metric::EXPLICIT:
+            diff.second = cities.weights[(size_t)cities.id[point_one] * cities.size() + cities.id[point_two]];
+            break;
+    }
     if (diff.second > std::numeric_limits<double>::max())   /// Check for possible overflow
     {
         diff.second = std::numeric_limits<double>::max();   /// Mask overflow
@@ -40,14 +97,14 @@ std::pair<int, long double> tsp_hop_cost(const std::pair<int, int> point_one, co
  *     of all those elements is the total distance which due to computer
  *     overflow warning are separated using that vector.
  */
-std::vector<long double> tsp_tour_cost(const std::array<std::pair<int, int>, N_POINTS> cities)
+std::vector<long double> tsp_tour_cost(const Instance& cities)
 {
     std::vector<long double> cost;                          /// Declares the costs vector
     cost.reserve(10);                                       /// Reserves a proper ammount of memory 
     int overflow = 1;                                       /// Sets overflow flag
     for (int i = 0; i < cities.size() - 1; i += 1)
     {
-        std::pair<int, long double> diff = tsp_hop_cost(cities.at(i), cities.at(i + 1));
+        std::pair<int, long double> diff = tsp_hop_cost(cities, i, i + 1);
                                                             /// Computes the Euclidean distance between 2 points 
         if (overflow)                                       /// Masks possible overflow error
         {
@@ -70,113 +127,173 @@ std::vector<long double> tsp_tour_cost(const std::array<std::pair<int, int>, N_P
  *      - Point B and its successor
  * 
  * @param[in] is_neighbor this is a flag indicating that Point A is either a predecessor or a successor of Point B
- * @param[in] pre_point_one this is the predecessor of Point A
- * @param[in] point_one this is Point A
- * @param[in] suc_point_one this is the successor of Point A
- * @param[in] pre_point_two this is the predecessor of Point B
- * @param[in] point_two this is Point B
- * @param[in] suc_point_two this is the successor of Point B
+ * @param[in] cities the dataset that holds the coordinates of the points
+ * @param[in] pre_point_one this is the index of the predecessor of Point A
+ * @param[in] point_one this is the index of Point A
+ * @param[in] suc_point_one this is the index of the successor of Point A
+ * @param[in] pre_point_two this is the index of the predecessor of Point B
+ * @param[in] point_two this is the index of Point B
+ * @param[in] suc_point_two this is the index of the successor of Point B
  * 
  * @return the sum of the distances described above.
- * 
- * @note it also masks possible integer overflow fault.
  */
 long double euclidean_difference(int is_neighbor,
-    const std::pair<int, int> pre_point_one,
-    const std::pair<int, int> point_one,
-    const std::pair<int, int> suc_point_one,
-    const std::pair<int, int> pre_point_two,
-    const std::pair<int, int> point_two,
-    const std::pair<int, int> suc_point_two)
+    const Instance& cities,
+    const int pre_point_one,
+    const int point_one,
+    const int suc_point_one,
+    const int pre_point_two,
+    const int point_two,
+    const int suc_point_two)
 {
-    long int pred_diff_point_one = ((pre_point_one.first - point_one.first) * (pre_point_one.first - point_one.first)) +
-        ((pre_point_one.second - point_one.second) * (pre_point_one.second - point_one.second));    /// Computes Euclidean distance between Point A and its predecessor
-    long int succ_diff_point_one = ((suc_point_one.first - point_one.first) * (suc_point_one.first - point_one.first)) +
-        ((suc_point_one.second - point_one.second) * (suc_point_one.second - point_one.second));    /// Computes Euclidean distance between Point A and its successor
-    long int pred_diff_point_two = ((pre_point_two.first - point_two.first) * (pre_point_two.first - point_two.first)) +
-        ((pre_point_two.second - point_two.second) * (pre_point_two.second - point_two.second));    /// Computes Euclidean distance between Point B and its predecessor
-    long int succ_diff_point_two = ((suc_point_two.first - point_two.first) * (suc_point_two.first - point_two.first)) +
-        ((suc_point_two.second - point_two.second) * (suc_point_two.second - point_two.second));    /// Computes Euclidean distance between Point B and its successor
-    if (pred_diff_point_one > std::numeric_limits<int>::max())
-    {
-        pred_diff_point_one = std::numeric_limits<int>::max();                                      /// Masks possible integer overflow in `pred_diff_point_one`
-    }
-    if (succ_diff_point_one > std::numeric_limits<int>::max())                                      /// Masks possible integer overflow in `succ_diff_point_one`
-    {
-        succ_diff_point_one = std::numeric_limits<int>::max();
-    }
-    if (pred_diff_point_two > std::numeric_limits<int>::max())                                      /// Masks possible integer overflow in `pred_diff_point_two`
-    {
-        pred_diff_point_two = std::numeric_limits<int>::max();
-    }
-    if (succ_diff_point_two > std::numeric_limits<int>::max())                                      /// Masks possible integer overflow in `succ_diff_point_two`
-    {
-        succ_diff_point_two = std::numeric_limits<int>::max();
-    }
+    long double pred_diff_point_one = tsp_hop_cost(cities, pre_point_one, point_one).second;   /// Computes Euclidean distance between Point A and its predecessor
+    long double succ_diff_point_one = tsp_hop_cost(cities, suc_point_one, point_one).second;   /// Computes Euclidean distance between Point A and its successor
+    long double pred_diff_point_two = tsp_hop_cost(cities, pre_point_two, point_two).second;   /// Computes Euclidean distance between Point B and its predecessor
+    long double succ_diff_point_two = tsp_hop_cost(cities, suc_point_two, point_two).second;   /// Computes Euclidean distance between Point B and its successor
 
     if (is_neighbor)
     {
-        return std::sqrt(pred_diff_point_one) + std::sqrt(succ_diff_point_two);                     /// If the given points are neighbors, it corrects the sum of distance
+        return pred_diff_point_one + succ_diff_point_two;                                       /// If the given points are neighbors, it corrects the sum of distance
     }
     else
     {
-        return std::sqrt(pred_diff_point_one) + std::sqrt(succ_diff_point_one) + std::sqrt(pred_diff_point_two) + std::sqrt(succ_diff_point_two);
+        return pred_diff_point_one + succ_diff_point_one + pred_diff_point_two + succ_diff_point_two;
     }
 }
 
-/*
- * Evaluates all possible edge costs in ACS.
+/**
+ * Computes the change of the TSP tour cost when a segment of the route is moved between two other cities (Or-opt move).
+ * 
+ * @param[in] cities the dataset that holds the coordinates of the points
+ * @param[in] pre_segment this is the index of the city before the segment, on the side of `segment_one`
+ * @param[in] segment_one this is the index of the first end of the segment
+ * @param[in] segment_two this is the index of the second end of the segment
+ * @param[in] suc_segment this is the index of the city after the segment, on the side of `segment_two`
+ * @param[in] point_one this is the index of the city that becomes adjacent to `segment_one`
+ * @param[in] point_two this is the index of the city that becomes adjacent to `segment_two`
+ * 
+ * @return the cost of the edges (`pre_segment`, `suc_segment`), (`point_one`, `segment_one`) and (`point_two`, `segment_two`)
+ *      minus the cost of the edges (`pre_segment`, `segment_one`), (`segment_two`, `suc_segment`) and (`point_one`, `point_two`).
+ *      A negative value means that the move shortens the TSP route.
  * 
- * @param[in] non_explored the vector of the ant path sorted in non explored points and explored ones
- * @param[in] ant_idx the current ant number (index) calling this function to evaluate its path
- * @param[in] last_explored_idx the index to the last explored element in `non_explored` vector
- * @param[in] pherormone_matrix the matrix in which ant pherormone is stored
+ * @note the segment is reversed by the move if `point_one` lies after `point_two` in the direction from `segment_one` to 
+ *      `segment_two`. Either way, the cities inside the segment keep their edges, so the move is evaluated in O(1).
+ */
+long double or_opt_difference(
+    const Instance&                                         cities,
+    const int                                               pre_segment,
+    const int                                               segment_one,
+    const int                                               segment_two,
+    const int                                               suc_segment,
+    const int                                               point_one,
+    const int                                               point_two)
+{
+    const long double removed = tsp_hop_cost(cities, pre_segment, segment_one).second
+        + tsp_hop_cost(cities, segment_two, suc_segment).second
+        + tsp_hop_cost(cities, point_one, point_two).second;  /// Computes the cost of the edges that are removed
+    const long double added = tsp_hop_cost(cities, pre_segment, suc_segment).second
+        + tsp_hop_cost(cities, point_one, segment_one).second
+        + tsp_hop_cost(cities, point_two, segment_two).second;/// Computes the cost of the edges that are added
+    return added - removed;
+}
+
+/**
+ * Evaluates the edges that an ant may follow in ACS.
+ * 
+ * @param[in] non_explored the cities, where the first `last_explored_idx` + 1 have been explored by the ant
+ * @param[in] position the position of each city inside `non_explored`
+ * @param[in] last_explored_idx the index to the last explored element in `non_explored` vector, which is the city the ant is at
+ * @param[in] pherormone the store in which ant pherormone is stored (see `Pherormone.h`)
+ * @param[in] choice_info the tabulated evaluation of the candidate edges (see `ChoiceInfo` in `Pherormone.h`), or nullptr to evaluate them here
  * @param[in] cities the dataset generated in the beginning containing the <x, y> coordinates of the points (cities)
- * @param[in, out] evaluation this is the vector where we store each edge cost
+ * @param[in] candidates the candidate lists of `cities` (see `Candidates.h`)
+ * @param[in, out] evaluation this is the vector where we store each edge cost. It is cleared first, and it must have
+ *      enough capacity for all the cities, so that no memory is allocated
+ * 
+ * @note only the unexplored candidates of the city are evaluated, which costs O(k). A city is unexplored if its
+ *      position lies after `last_explored_idx`, so no search is needed. Only if all the candidates have been 
+ *      explored, every unexplored city is evaluated, which costs O(n).
  */
+template <typename Store>
 void evaluate_universe(
-    const std::vector<std::array<int, N_POINTS>>            non_explored,
-    const int                                               ant_idx,
+    const std::vector<int>&                                 non_explored,
+    const std::vector<int>&                                 position,
     const int                                               last_explored_idx,
-    const std::vector<std::array<double, N_POINTS>>         pherormone_matrix,
-    const std::array<std::pair<int, int>, N_POINTS>         cities,
+    const Store&                                            pherormone,
+    const ChoiceInfo*                                       choice_info,
+    const Instance&                                         cities,
+    const CandidateList&                                    candidates,
     std::vector<std::pair<int, double>>&                    evaluation)
 {
-    for (int l = last_explored_idx + 1; l < N_POINTS; l += 1)
+    const int current = non_explored[last_explored_idx];
+    const int* neighbors = candidates.neighbors_of(current);
+    const double* distances = candidates.distances_of(current);
+    std::array<int, EVALUATION_BLOCK> targets;              /// The cities of a block of edges
+    std::array<double, EVALUATION_BLOCK> lengths;           /// The lengths of a block of candidate edges
+    std::array<double, EVALUATION_BLOCK> tau;               /// The pherormone of a block of edges
+    std::array<double, EVALUATION_BLOCK> attractiveness;    /// The evaluation of a block of edges
+    evaluation.clear();
+    if (choice_info != nullptr)                             /// The evaluation of the candidate edges has been tabulated, so it is only loaded
     {
-        double cost = tsp_hop_cost(cities.at(non_explored.at(ant_idx).at(last_explored_idx)), cities.at(non_explored.at(ant_idx).at(l))).second;
-                                                            /// Computes the cost between the last explored node and every other possible node
-        double pherormone = pherormone_matrix.at(non_explored.at(ant_idx).at(last_explored_idx)).at(non_explored.at(ant_idx).at(l));
-                                                            /// Fetches the pherormone assigned to that edge
-        evaluation.emplace_back(std::make_pair(non_explored.at(ant_idx).at(l), pherormone * (1 / cost)));
-                                                            /// Evaluates that edge based on the cost and its past pherormone
+        const double* choice = choice_info->choice_of(current);
+        for (int l = 0; l < candidates.k; l += 1)
+        {
+            if (position[neighbors[l]] > last_explored_idx) { evaluation.emplace_back(neighbors[l], choice[l]); }
+        }
+    }
+    for (int l = 0; choice_info == nullptr && l < candidates.k; l += EVALUATION_BLOCK)
+    {
+        int count = 0;
+        for (int slot = l; slot < std::min(l + EVALUATION_BLOCK, candidates.k); slot += 1)
+        {
+            if (position[neighbors[slot]] <= last_explored_idx) { continue; }
+                                                            /// Skips the candidates that have been explored
+            targets[count] = neighbors[slot];
+            lengths[count] = distances[slot];
+            tau[count] = pherormone.candidate(current, slot);
+            count += 1;
+        }
+        candidate_attractiveness(tau.data(), lengths.data(), count, attractiveness.data());
+                                                            /// Evaluates those edges based on the cost and their past pherormone
+        for (int i = 0; i < count; i += 1) { evaluation.emplace_back(targets[i], attractiveness[i]); }
+    }
+    if (!evaluation.empty()) { return; }
+    for (int l = last_explored_idx + 1; l < cities.size(); l += EVALUATION_BLOCK)
+    {
+        const int count = std::min(EVALUATION_BLOCK, cities.size() - l);
+        for (int i = 0; i < count; i += 1)
+        {
+            tau[i] = pherormone.non_candidate(current, non_explored[l + i]);
+        }
+        edge_attractiveness(cities, current, non_explored.data() + l, tau.data(), count, attractiveness.data());
+                                                            /// Computes the cost between the last explored node and a block of other possible nodes
+        for (int i = 0; i < count; i += 1) { evaluation.emplace_back(non_explored[l + i], attractiveness[i]); }
     }
 }
 
-/*
- * Evaluates all possible edge costs in ACS. This is a fork of the `evaluate_universe` function above, fine tuned for the parallelized version of ACS.
- *
- * @param[in] non_explored the array of the ant path sorted in non explored points and explored ones
- * @param[in] last_explored_idx the index to the last explored element in `non_explored` vector
- * @param[in] pherormone_matrix the matrix in which ant pherormone is stored
- * @param[in] cities the dataset generated in the beginning containing the <x, y> coordinates of the points (cities)
- * @param[in, out] evaluation this is the vector where we store each edge cost
+template void evaluate_universe<DensePherormone>(const std::vector<int>&, const std::vector<int>&, const int, const DensePherormone&, const ChoiceInfo*, const Instance&, const CandidateList&, std::vector<std::pair<int, double>>&);
+template void evaluate_universe<SparsePherormone>(const std::vector<int>&, const std::vector<int>&, const int, const SparsePherormone&, const ChoiceInfo*, const Instance&, const CandidateList&, std::vector<std::pair<int, double>>&);
+template void evaluate_universe<CompactPherormone>(const std::vector<int>&, const std::vector<int>&, const int, const CompactPherormone&, const ChoiceInfo*, const Instance&, const CandidateList&, std::vector<std::pair<int, double>>&);
+
+/**
+ * Computes the cost of a closed TSP tour.
+ * 
+ * @param[in] tsp_route the node indexes of the tour with respect to `cities` variable
+ * @param[in] cities the dataset of points (cities)
+ * 
+ * @return the cost of the tour, including the edge that returns to the first city
  */
-void evaluate_universe_parallel(
-    const std::array<int, N_POINTS>                         non_explored,
-    const int                                               last_explored_idx,
-    const std::vector<std::array<double, N_POINTS>>         pherormone_matrix,
-    const std::array<std::pair<int, int>, N_POINTS>         cities,
-    std::vector<std::pair<int, double>>&                    evaluation)
+double tsp_route_cost(const std::vector<int>& tsp_route, const Instance& cities)
 {
-    for (int l = last_explored_idx + 1; l < N_POINTS; l += 1)
+    double cost = 0.0;
+    for (int i = 0; i < (int)tsp_route.size() - 1; i += 1)
     {
-        double cost = tsp_hop_cost(cities.at(non_explored.at(last_explored_idx)), cities.at(non_explored.at(l))).second;
-        double pherormone = pherormone_matrix.at(non_explored.at(last_explored_idx)).at(non_explored.at(l));
-        evaluation.emplace_back(std::make_pair(non_explored.at(l), pherormone * (1 / cost)));
+        cost += tsp_hop_cost(cities, tsp_route[i], tsp_route[i + 1]).second;
     }
-}
+    cost += tsp_hop_cost(cities, tsp_route.back(), tsp_route.front()).second;
 
+    return cost;
+}
 
 /**
  * Computes ACS TSP tour cost.
@@ -186,14 +303,7 @@ void evaluate_universe_parallel(
  * 
  * @return the cost of the estimated TSP route by ACS
  */
-double acs_tsp_cost(const std::vector<int> tsp_route, const std::array<std::pair<int, int>, N_POINTS> cities)
+double acs_tsp_cost(const std::vector<int> tsp_route, const Instance& cities)
 {
-    double cost = 0.0;
-    for (int i = 0; i < tsp_route.size() - 1; i += 1)
-    {
-        cost += tsp_hop_cost(cities.at(tsp_route.at(i)), cities.at(tsp_route.at(i + 1))).second;
-    }
-    cost += tsp_hop_cost(cities.at(tsp_route.at(tsp_route.size() - 1)), cities.at(tsp_route.at(0))).second;
-
-    return cost;
+    return tsp_route_cost(tsp_route, cities);
 }
@@ -11,10 +11,17 @@
 #pragma once
 
 #include "Common.h"
+#include "Instance.h"
 
-std::pair<int, long double> tsp_hop_cost(const std::pair<int, int> point_one, const std::pair<int, int> point_two);
-std::vector<long double> tsp_tour_cost(const std::array<std::pair<int, int>, N_POINTS> cities);
-long double euclidean_difference(int is_neighbor, const std::pair<int, int> pre_point_one, const std::pair<int, int> point_one, const std::pair<int, int> suc_point_one, const std::pair<int, int> pre_point_two, const std::pair<int, int> point_two, const std::pair<int, int> suc_point_two);
-void evaluate_universe(const std::vector<std::array<int, N_POINTS>> non_explored, const int ant_idx, const int last_explored_idx, const std::vector<std::array<double, N_POINTS>> pherormone_matrix, const std::array<std::pair<int, int>, N_POINTS> cities, std::vector<std::pair<int, double>>& evaluation);
-void evaluate_universe_parallel(const std::array<int, N_POINTS> non_explored, const int last_explored_idx, const std::vector<std::array<double, N_POINTS>> pherormone_matrix, const std::array<std::pair<int, int>, N_POINTS> cities, std::vector<std::pair<int, double>>& evaluation);
-double acs_tsp_cost(const std::vector<int> tsp_route, const std::array<std::pair<int, int>, N_POINTS> cities);
+struct CandidateList;
+class ChoiceInfo;
+
+double geo_radians(const double coordinate);
+std::pair<int, long double> tsp_hop_cost(const Instance& cities, const int point_one, const int point_two);
+std::vector<long double> tsp_tour_cost(const Instance& cities);
+long double euclidean_difference(int is_neighbor, const Instance& cities, const int pre_point_one, const int point_one, const int suc_point_one, const int pre_point_two, const int point_two, const int suc_point_two);
+long double or_opt_difference(const Instance& cities, const int pre_segment, const int segment_one, const int segment_two, const int suc_segment, const int point_one, const int point_two);
+template <typename Store>
+void evaluate_universe(const std::vector<int>& non_explored, const std::vector<int>& position, const int last_explored_idx, const Store& pherormone, const ChoiceInfo* choice_info, const Instance& cities, const CandidateList& candidates, std::vector<std::pair<int, double>>& evaluation);
+double tsp_route_cost(const std::vector<int>& tsp_route, const Instance& cities);
+double acs_tsp_cost(const std::vector<int> tsp_route, const Instance& cities);
@@ -1,47 +1,106 @@
-
 #include "Driver.h"
 
 /**
  * Implements the driver for the different approaches that solve the TSP.
  * 
+ * @param[in] argc the number of command line arguments
+ * @param[in] argv the command line arguments (see print_usage() in `Interface.cpp`)
+ * 
  * @return 0, if the executable was terminated normally
  */
-int main(void)
+int main(int argc, char* argv[])
 {
-    std::array<std::pair<int, int>, N_POINTS> cities;                                                                   /// Declares a vector to store the dataset 
-    if (FIXED_MODE) { set_fixed_dataset(cities); }                                                                      /// If in FIXED_MODE fix - initialize the dataset 
-    else { initialize_cities(cities); }                                                                                 /// Else initialize the dataset with random points
+    Settings settings;                                                                                                  /// Declares the run time settings, initialized by the constants of `Common.h`
+    if (!parse_arguments(argc, argv, settings)) { return 0; }                                                           /// Overrides the settings with the command line arguments
+    std::cout << "Random seed: " << settings.seed << std::endl;                                                         /// Prints the seed, so that the run can be repeated with `--seed`
+    select_simd(settings.simd);                                                                                         /// Selects the instruction set of the vectorized kernels
+    Instance cities;                                                                                                    /// Declares a heap backed instance to store the dataset 
+    std::chrono::time_point<std::chrono::system_clock> load_start = std::chrono::system_clock::now();
+    if (!settings.input.empty() && load_tsplib_instance(settings.input, cities))                                        /// If a TSPLIB instance was given, load it
+    {
+        std::chrono::duration<double> load_seconds = std::chrono::system_clock::now() - load_start;
+        std::cout << "Loaded \"" << cities.name << "\" (" << cities.size() << " cities) in " << load_seconds.count() << " seconds" << std::endl;
+    }
+    else if (FIXED_MODE) { set_fixed_dataset(cities); }                                                                 /// Else if in FIXED_MODE fix - initialize the dataset 
+    else { initialize_cities(cities, settings.n_points, settings.seed); }                                               /// Else initialize the dataset with random points
+    if (settings.renumber)                                                                                              /// Renumbers the cities along a Hilbert curve, before any structure refers to them by index
+    {
+        std::chrono::time_point<std::chrono::system_clock> renumber_start = std::chrono::system_clock::now();
+        hilbert_renumber(cities);
+        std::chrono::duration<double> renumber_seconds = std::chrono::system_clock::now() - renumber_start;
+        std::cout << "Renumbered " << cities.size() << " cities along a Hilbert curve in " << renumber_seconds.count() << " seconds" << std::endl;
+    }
+    if (!settings.benchmark.empty())                                                                                    /// Measures a component instead of executing an algorithm
+    {
+        run_benchmark(cities, settings);
+        return 0;
+    }
     std::string algorithm;                                                                                              /// Declares a string to associate it with the algorithm running
+    std::vector<int> tsp_route;                                                                                         /// Declares a vector to store the TSP route of the algorithms that do not reorder `cities`
+    CandidateList candidates;                                                                                           /// Declares the candidate lists, which are built by the algorithms that consume them
     std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();                        /// Declares a starting time point which helps in benchmarking
-    switch (ALGORITHM)                                                                                                  /// Depending on the algorithm selected by the user call the appropriate routine
+    switch (settings.algorithm)                                                                                         /// Depending on the algorithm selected by the user call the appropriate routine
     {
         case 0:
             algorithm.assign("[ALGO 0] \"Naive TSP\"");
-            naive_tsp(cities); 
+            naive_tsp(cities, settings); 
             break;
         case 1:
             algorithm.assign("[ALGO 1] \"Naive TSP\" (Parallel Implementation)");
-            naive_tsp_parallel(cities); 
+            naive_tsp_parallel(cities, settings); 
             break;
         case 2:
             algorithm.assign("[ALGO 2] \"TSP with nearest neighbor\"");
-            heinritz_hsiao(cities); 
+            build_candidates(cities, settings.candidates, settings.quadrant_candidates, candidates);
+            heinritz_hsiao(cities, candidates); 
             break;
         case 3:
             algorithm.assign("[ALGO 3] \"TSP with naive nearest neighbor\"");
-            naive_heinritz_hsiao(cities); 
+            build_candidates(cities, settings.candidates, settings.quadrant_candidates, candidates);
+            naive_heinritz_hsiao(cities, candidates, settings); 
             break;
         case 4:
             algorithm.assign("[ALGO 4] \"TSP with naive nearest neighbor\" (Parallel Implementation)");
-            naive_heinritz_hsiao_parallel(cities); 
+            naive_heinritz_hsiao_parallel(cities, settings); 
             break;
         case 5:
             algorithm.assign("[ALGO 5] \"ACS TSP\"");
-            ant_colony(cities);
+            build_candidates(cities, settings.candidates, settings.quadrant_candidates, candidates);
+            ant_colony(cities, candidates, settings, tsp_route);
             break;
         case 6:
             algorithm.assign("[ALGO 6] \"ACS TSP\" (Parallel Implementation)");
-            ant_colony_parallel(cities);
+            build_candidates(cities, settings.candidates, settings.quadrant_candidates, candidates);
+            ant_colony_parallel(cities, candidates, settings, tsp_route);
+            break;
+        case 7:
+            algorithm.assign("[ALGO 7] \"TSP with Lin - Kernighan\"");
+            build_candidates(cities, settings.candidates, settings.quadrant_candidates, candidates);
+            settings.iterations = lin_kernighan(cities, settings, candidates, tsp_route);                               /// Reports the kicks applied, since the time budget usually stops the search first
+            break;
+        case 8:
+            algorithm.assign("[ALGO 8] \"Ant Colony System\"");
+            build_candidates(cities, settings.candidates, settings.quadrant_candidates, candidates);
+            ant_colony_system(cities, candidates, settings, tsp_route);
+            break;
+        case 9:
+            algorithm.assign("[ALGO 9] \"MAX - MIN Ant System\"");
+            build_candidates(cities, settings.candidates, settings.quadrant_candidates, candidates);
+            max_min_ant_system(cities, candidates, settings, tsp_route);
+            break;
+        case 10:
+            algorithm.assign("[ALGO 10] \"TSP with space filling curve\"");
+            space_filling_curve(cities, tsp_route);
+            break;
+        case 11:
+            algorithm.assign("[ALGO 11] \"TSP with greedy edge\"");
+            build_candidates(cities, settings.candidates, settings.quadrant_candidates, candidates);
+            greedy_edge(cities, candidates, tsp_route);
+            break;
+        case 12:
+            algorithm.assign("[ALGO 12] \"TSP with savings\"");
+            build_candidates(cities, settings.candidates, settings.quadrant_candidates, candidates);
+            savings(cities, candidates, tsp_route);
             break;
         default:
             std::cout << "[Warning]: Invalid algorithm setting\n\t[\"Unknown algorithm\" fault masked]" << std::endl;   /// Mask unknown algorithm fault
@@ -49,7 +108,29 @@ int main(void)
     }
     std::chrono::time_point<std::chrono::system_clock> end = std::chrono::system_clock::now();                          /// Declares an ending time point which helps in benchmarking
     std::chrono::duration<double> elapsed_seconds = end - start;                                                        /// Computes execution time
-    std::cout << algorithm << " terminated after " << ITERATIONS << " iterations with a total of " << elapsed_seconds.count() << " seconds" << std::endl;
+    std::cout << algorithm << " terminated after " << settings.iterations << " iterations on " << cities.size() << " cities with a total of " << elapsed_seconds.count() << " seconds" << std::endl;
                                                                                                                         /// Outputs results
+    if (tsp_route.empty())                                                                                              /// The naive approaches encode the TSP route as the order of `cities`
+    {
+        tsp_route.resize(cities.size());
+        std::iota(tsp_route.begin(), tsp_route.end(), 0);
+    }
+    if (settings.local_search != 0)                                                                                     /// Improves the TSP route of any approach with the local search
+    {
+        const double initial_cost = tsp_route_cost(tsp_route, cities);
+        start = std::chrono::system_clock::now();
+        const int moves = local_search(cities, settings, candidates, tsp_route);
+        elapsed_seconds = std::chrono::system_clock::now() - start;
+        std::cout << "\tLocal search applied " << moves << " moves in " << elapsed_seconds.count() << " seconds" << std::endl;
+        std::cout << "\tTSP tour cost before local search: " << std::fixed << std::setprecision(2) << initial_cost << std::endl;
+    }
+    std::cout << "\tTSP tour cost: " << std::fixed << std::setprecision(2) << tsp_route_cost(tsp_route, cities) << std::endl;
+    if (!settings.tour_output.empty()) { export_tsplib_tour(settings.tour_output, cities, tsp_route); }                 /// Exports the TSP route to a TSPLIB tour
+    std::vector<int> optimal_route;
+    if (!settings.optimal_tour.empty() && load_tsplib_tour(settings.optimal_tour, cities, optimal_route))               /// Compares the TSP route with a known optimum
+    {
+        const double optimal_cost = tsp_route_cost(optimal_route, cities);
+        std::cout << "\tOptimal tour cost: " << optimal_cost << " (gap " << 100.0 * (tsp_route_cost(tsp_route, cities) / optimal_cost - 1.0) << "%)" << std::endl;
+    }
     return 0;
 }
@@ -11,12 +11,18 @@
 #pragma once
 
 #include "City.h"
+#include "Benchmark.h"
+#include "Candidates.h"
+#include "Construction.h"
 #include "Naive.h"
 #include "Common.h"
 #include "Colonize.h"
 #include "Distance.h"
+#include "Instance.h"
 #include "Interface.h"
 #include "Utilities.h"
 #include "Operation.h"
 #include "Pherormone.h"
+#include "Tsplib.h"
+#include "Hilbert.h"
 #include "Validation.h"
@@ -0,0 +1,89 @@
+#include "Hilbert.h"
+
+/**
+ * Computes the distance of a cell along the Hilbert curve that covers the grid.
+ *
+ * @param[in] x the column of the cell, in [0, 2^`HILBERT_ORDER`)
+ * @param[in] y the row of the cell, in [0, 2^`HILBERT_ORDER`)
+ *
+ * @return the number of cells the curve visits before the cell
+ *
+ * @note the quadrant of the cell is resolved from the coarsest level to the finest one, and the
+ *      coordinates are rotated at every level, so that the curve enters and leaves every quadrant
+ *      at adjacent cells. That is why consecutive cells of the curve are always neighbors.
+ */
+std::uint64_t hilbert_index(std::uint32_t x, std::uint32_t y)
+{
+    std::uint64_t index = 0;
+    for (std::uint32_t side = 1u << (HILBERT_ORDER - 1); side > 0; side >>= 1)
+    {
+        const std::uint32_t right = ((x & side) > 0 ? 1 : 0);
+        const std::uint32_t up = ((y & side) > 0 ? 1 : 0);
+        index += (std::uint64_t)side * side * ((3 * right) ^ up);
+                                                            /// Skip the quadrants that the curve visits before the quadrant of the cell
+        if (up == 0)                                        /// Rotate the quadrant, so that the curve of the next level starts at its origin
+        {
+            if (right == 1)
+            {
+                x = side - 1 - (x & (side - 1));
+                y = side - 1 - (y & (side - 1));
+            }
+            std::swap(x, y);
+        }
+    }
+    return index;
+}
+
+/**
+ * Sorts the cities along the Hilbert curve.
+ *
+ * @param[in] cities the dataset
+ * @param[out] order the cities in the order of the curve
+ *
+ * @note the keys of the cities are computed in parallel, and ties between cities of the same cell
+ *      are broken by the index of the cities, so the order is the same on every run.
+ */
+void hilbert_order(const Instance& cities, std::vector<int>& order)
+{
+    const int n_points = cities.size();
+    order.resize(n_points);
+    if (n_points == 0) { return; }
+    const auto x_range = std::minmax_element(cities.x.begin(), cities.x.end());
+    const auto y_range = std::minmax_element(cities.y.begin(), cities.y.end());
+    const double min_x = *x_range.first;
+    const double min_y = *y_range.first;
+    const double extent = std::max(*x_range.second - min_x, *y_range.second - min_y);
+                                                            /// A square grid, so that the cells are square on the map as well
+    const double cells = (double)((1u << HILBERT_ORDER) - 1);
+    const double scale = (extent > 0.0 ? cells / extent : 0.0);
+
+    std::vector<std::pair<std::uint64_t, int>> keys(n_points);
+#pragma omp parallel for schedule(static)
+    for (int i = 0; i < n_points; i += 1)
+    {
+        const std::uint32_t x = (std::uint32_t)((cities.x[i] - min_x) * scale);
+        const std::uint32_t y = (std::uint32_t)((cities.y[i] - min_y) * scale);
+        keys[i] = std::make_pair(hilbert_index(x, y), i);
+    }
+    std::sort(keys.begin(), keys.end());
+    for (int i = 0; i < n_points; i += 1)
+    {
+        order[i] = keys[i].second;
+    }
+}
+
+/**
+ * Renumbers the cities along the Hilbert curve, so that cities that are close on the map are also close in memory.
+ *
+ * @param[in, out] cities the dataset to be renumbered
+ *
+ * @note the original identifier of every city follows it (see `Instance::reorder()`), so the exported
+ *      tours and the `EXPLICIT` distances still refer to the original cities. The renumbering must
+ *      precede every structure that refers to the cities by index, such as the candidate lists.
+ */
+void hilbert_renumber(Instance& cities)
+{
+    std::vector<int> order;
+    hilbert_order(cities, order);
+    cities.reorder(order);
+}
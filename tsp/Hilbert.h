@@ -0,0 +1,29 @@
+/**
+ * Hilbert.h
+ *
+ * In this header file, we define the space filling curve
+ * of the project. The cities are generated (or read) in an
+ * arbitrary order, so cities that are close on the map are
+ * scattered across the coordinate arrays, and every scan of
+ * the neighbors of a city misses the cache. Sorting the
+ * cities along a Hilbert curve keeps the neighbors of most
+ * cities close in memory as well. The cities are quantized
+ * to a 2^`HILBERT_ORDER` x 2^`HILBERT_ORDER` grid over their
+ * bounding box, and sorted by the distance along the curve
+ * of their cell, which costs O(n log n). The same order is
+ * also a TSP route, which visits the cities cell by cell,
+ * and is usually 10% to 25% longer than the optimal route
+ * on uniformly random cities.
+ *
+ * @remark https://en.wikipedia.org/wiki/Hilbert_curve
+ * @remark https://doi.org/10.1016/0167-6377(82)90038-5
+ */
+
+#pragma once
+
+#include "Common.h"
+#include "Instance.h"
+
+std::uint64_t hilbert_index(const std::uint32_t x, const std::uint32_t y);
+void hilbert_order(const Instance& cities, std::vector<int>& order);
+void hilbert_renumber(Instance& cities);
@@ -0,0 +1,88 @@
+/**
+ * Instance.h
+ *
+ * In this header file, we define the container that
+ * holds a TSP problem instance. The coordinates of the
+ * cities are stored on the heap in a structure of arrays 
+ * layout (one contiguous array for the X coordinates and 
+ * one for the Y coordinates). That way the size of the 
+ * instance is decided at run time and the cost functions
+ * sweep over contiguous memory.
+ *
+ * An instance also carries the metric used to measure the
+ * distance between two cities. Randomly generated instances
+ * use the plain Euclidean distance, while instances loaded 
+ * from TSPLIB files use the metric declared in the file.
+ */
+
+#pragma once
+
+#include "Common.h"
+
+/**
+ * The distance functions supported by the project.
+ *
+ * @remark http://comopt.ifi.uni-heidelberg.de/software/TSPLIB95/tsp95.pdf
+ */
+enum class Metric
+{
+    EUCLIDEAN,                                              /// Plain Euclidean distance, used by the randomly generated instances
+    EUC_2D,                                                 /// TSPLIB Euclidean distance rounded to the nearest integer
+    CEIL_2D,                                                /// TSPLIB Euclidean distance rounded up to the next integer
+    ATT,                                                    /// TSPLIB pseudo-Euclidean distance
+    GEO,                                                    /// TSPLIB geographical distance
+    EXPLICIT                                                /// TSPLIB distances given explicitly as a matrix
+};
+
+/**
+ * A runtime sized TSP instance.
+ *
+ * @note the naive approaches of the project encode the TSP route as the
+ *      order of the cities inside the instance. Therefore, swapping two
+ *      cities with `swap()` also updates the route.
+ *
+ * @note `Metric::EXPLICIT` instances are addressed by the original 
+ *      identifiers of the cities, so they remain valid when cities are swapped.
+ */
+struct Instance
+{
+    std::vector<double> x;                                  /// The "Longitude" of each city
+    std::vector<double> y;                                  /// The "Latitude" of each city
+    std::vector<int> id;                                    /// The original (zero based) identifier of each city, which follows the city when it is swapped
+    std::vector<double> weights;                            /// The `n_points` x `n_points` distance matrix, only used by `Metric::EXPLICIT`
+    Metric metric = Metric::EUCLIDEAN;                      /// The distance function of the instance
+    std::string name;                                       /// The name of the instance
+
+    int size() const { return (int)x.size(); }              /// Returns the number of cities
+    void resize(const int n_points)                         /// Resizes the instance to `n_points` cities and resets the identifiers
+    {
+        x.resize(n_points);
+        y.resize(n_points);
+        id.resize(n_points);
+        std::iota(id.begin(), id.end(), 0);
+    }
+    void swap(const int a, const int b)                     /// Swaps the position of two cities
+    {
+        std::swap(x[a], x[b]);
+        std::swap(y[a], y[b]);
+        std::swap(id[a], id[b]);
+    }
+    void reorder(const std::vector<int>& order)             /// Reorders the cities so that the `i`-th city becomes the city `order[i]`
+    {
+        std::vector<double> ordered_x(order.size()), ordered_y(order.size());
+        std::vector<int> ordered_id(order.size());
+        for (size_t i = 0; i < order.size(); i += 1)
+        {
+            ordered_x[i] = x[order[i]];
+            ordered_y[i] = y[order[i]];
+            ordered_id[i] = id[order[i]];
+        }
+        x.swap(ordered_x);
+        y.swap(ordered_y);
+        id.swap(ordered_id);
+    }
+    bool is_geometric() const                               /// Returns true if the nearest city in the plane is also the nearest city with respect to the metric
+    {
+        return (metric == Metric::EUCLIDEAN || metric == Metric::EUC_2D || metric == Metric::CEIL_2D || metric == Metric::ATT);
+    }
+};
@@ -29,11 +29,11 @@ void print_tsp_tour_cost(const std::vector<long double> cost)
  * 
  * @param[in] cities the cities (points) generated for the TSP
  */
-void print_cities(const std::array<std::pair<int, int>, N_POINTS> cities)
+void print_cities(const Instance& cities)
 {
-    for (int i = 0; i < N_POINTS; i += 1)
+    for (int i = 0; i < cities.size(); i += 1)
     {
-        std::cout << std::setw(15) << "[POINT (" << i << ")]:\t" << std::setw(5) << cities.at(i).first << "\t" << std::setw(5) << cities.at(i).second << std::endl;
+        std::cout << std::setw(15) << "[POINT (" << i << ")]:\t" << std::setw(5) << cities.x[i] << "\t" << std::setw(5) << cities.y[i] << std::endl;
     }
     std::cout << std::endl << std::endl;
 }
@@ -45,7 +45,7 @@ void print_cities(const std::array<std::pair<int, int>, N_POINTS> cities)
  * 
  * @note this function is called from print_matrx() function below
  */
-void print_row(const std::array<double, N_POINTS>& r)
+void print_row(const std::vector<double>& r)
 {
     for (auto const& element : std::as_const(r))
     {
@@ -59,7 +59,7 @@ void print_row(const std::array<double, N_POINTS>& r)
  * @param[in] matrix the 2d array to print
  * @param[in] matrix_name the string that describes the matrix (ex. the name of the matrix)
  */
-void print_matrix(const std::vector<std::array<double, N_POINTS>> matrix, const std::string matrix_name)
+void print_matrix(const std::vector<std::vector<double>> matrix, const std::string matrix_name)
 {
     std::cout << "Printing contents of \"" << matrix_name << "\"" << std::endl << "[";
     for (int col = 0; col < matrix.size(); col += 1)
@@ -83,3 +83,146 @@ void print_acs_tsp(const std::vector<int> tsp_route)
     }
     std::cout << std::endl;
 }
+
+/**
+ * Prints the command line arguments accepted by the executable.
+ * 
+ * @param[in] executable the name of the executable (`argv[0]`)
+ */
+void print_usage(const std::string executable)
+{
+    std::cout << "Usage: " << executable << " [options]" << std::endl
+        << "\t--algorithm <id>\t the algorithm to execute (see `ALGORITHM` in Common.h)" << std::endl
+        << "\t--cities <n>\t\t the number of random cities to generate" << std::endl
+        << "\t--iterations <n>\t the number of iterations to execute" << std::endl
+        << "\t--input <file>\t\t the TSPLIB instance (.tsp) to solve instead of random cities" << std::endl
+        << "\t--output-tour <file>\t the TSPLIB tour (.tour) where the computed tour is exported" << std::endl
+        << "\t--optimal-tour <file>\t the TSPLIB tour (.tour) of a known optimum to compare with" << std::endl
+        << "\t--candidates <k>\t the number of candidate neighbors of each city" << std::endl
+        << "\t--candidate-type <type>\t \"nearest\" or \"quadrant\" candidate neighbors" << std::endl
+        << "\t--local-search <moves>\t \"2-opt\", \"or-opt\", \"2-opt+or-opt\" or \"none\" local search" << std::endl
+        << "\t--parallel-local-search <on|off> evaluates the moves of the local search in parallel" << std::endl
+        << "\t--renumber <on|off>\t renumbers the cities along a Hilbert curve for cache locality" << std::endl
+        << "\t--time-limit <seconds>\t the time budget of the Lin - Kernighan algorithm" << std::endl
+        << "\t--pherormone <store>\t \"dense\", \"compact\", \"sparse\" or \"auto\" pherormone store of the ACS" << std::endl
+        << "\t--huge-pages <on|off>\t backs the compact pherormone store with huge pages" << std::endl
+        << "\t--ants <n>\t\t the number of ants (and threads of the parallel version) of the ACS" << std::endl
+        << "\t--deposit <mode>\t \"critical\", \"atomic\" or \"buffered\" pherormone deposits of the parallel ACS" << std::endl
+        << "\t--seed <n>\t\t the seed of every random choice, to repeat a run" << std::endl
+        << "\t--q0 <probability>\t the probability that an ant of the Ant Colony System follows the best edge" << std::endl
+        << "\t--track-best <on|off>\t keeps the best tour of every iteration of the ACS" << std::endl
+        << "\t--selection <method>\t \"sort\", \"top-k\", \"proportional\" or \"tournament\" edge selection of the ACS ants" << std::endl
+        << "\t--choice-info <on|off>\t tabulates the evaluation of the candidate edges once per iteration of the ACS" << std::endl
+        << "\t--simd <level>\t\t \"auto\", \"scalar\", \"avx2\" or \"avx512\" kernels of the ACS" << std::endl
+        << "\t--benchmark <name>\t executes the \"construction\", \"deposits\", \"kernel\", \"local-search\" or \"selection\" benchmark instead of an algorithm" << std::endl
+        << "\t--help\t\t\t prints this message" << std::endl;
+}
+
+/**
+ * Parses the local search moves of the command line.
+ *
+ * @param[in] value the moves joined with `+` (ex. "2-opt+or-opt"), or "none"
+ * @param[in, out] local_search the local search flags to be updated (see `LOCAL_SEARCH_*` in Common.h)
+ *
+ * @return false if any of the moves is unknown, in which case `local_search` is not updated
+ */
+bool parse_local_search(const std::string value, int& local_search)
+{
+    int flags = 0;
+    size_t begin = 0;
+    while (begin <= value.size())
+    {
+        size_t end = value.find('+', begin);
+        if (end == std::string::npos) { end = value.size(); }
+        const std::string move = value.substr(begin, end - begin);
+        if (move == "2-opt") { flags |= LOCAL_SEARCH_2OPT; }
+        else if (move == "or-opt") { flags |= LOCAL_SEARCH_OROPT; }
+        else if (move != "none") { return false; }
+        begin = end + 1;
+    }
+    local_search = flags;
+    return true;
+}
+
+/**
+ * Parses the command line arguments into the run time settings.
+ * 
+ * @param[in] argc the number of command line arguments
+ * @param[in] argv the command line arguments
+ * @param[in, out] settings the run time settings to be updated
+ * 
+ * @return false if the executable should terminate (ex. `--help` was given), else true
+ * 
+ * @note unknown or malformed arguments are reported and ignored, so that 
+ *      the corresponding setting keeps its default value from `Common.h`.
+ */
+bool parse_arguments(int argc, char* argv[], Settings& settings)
+{
+    for (int i = 1; i < argc; i += 1)
+    {
+        const std::string argument(argv[i]);
+        if (argument == "--help")
+        {
+            print_usage(argv[0]);
+            return false;
+        }
+        if (i + 1 >= argc)                                                          /// Every other argument expects a value
+        {
+            std::cout << "[Warning]: Missing value for argument \"" << argument << "\"\n\t[\"Missing value\" fault masked]" << std::endl;
+            break;
+        }
+        const std::string value(argv[i + 1]);
+        i += 1;
+        try
+        {
+            if (argument == "--algorithm") { settings.algorithm = std::stoi(value); }
+            else if (argument == "--cities") { settings.n_points = std::stoi(value); }
+            else if (argument == "--iterations") { settings.iterations = std::stoi(value); }
+            else if (argument == "--input") { settings.input = value; }
+            else if (argument == "--output-tour") { settings.tour_output = value; }
+            else if (argument == "--optimal-tour") { settings.optimal_tour = value; }
+            else if (argument == "--candidates") { settings.candidates = std::max(1, std::stoi(value)); }
+            else if (argument == "--time-limit") { settings.time_limit = std::max(0.0, std::stod(value)); }
+            else if (argument == "--local-search" && parse_local_search(value, settings.local_search)) {}
+            else if (argument == "--pherormone" && (value == "auto" || value == "dense" || value == "compact" || value == "sparse"))
+            {
+                settings.pherormone = (value == "dense" ? PHERORMONE_DENSE : value == "compact" ? PHERORMONE_COMPACT : value == "sparse" ? PHERORMONE_SPARSE : PHERORMONE_AUTO);
+            }
+            else if (argument == "--ants") { settings.ants = std::max(1, std::stoi(value)); }
+            else if (argument == "--benchmark") { settings.benchmark = value; }
+            else if (argument == "--seed") { settings.seed = std::max(0LL, std::stoll(value)); }
+            else if (argument == "--deposit" && (value == "critical" || value == "atomic" || value == "buffered"))
+            {
+                settings.deposit = (value == "critical" ? DEPOSIT_CRITICAL : value == "atomic" ? DEPOSIT_ATOMIC : DEPOSIT_BUFFERED);
+            }
+            else if (argument == "--simd" && (value == "auto" || value == "scalar" || value == "avx2" || value == "avx512"))
+            {
+                settings.simd = (value == "scalar" ? SIMD_SCALAR : value == "avx2" ? SIMD_AVX2 : value == "avx512" ? SIMD_AVX512 : SIMD_AUTO);
+            }
+            else if (argument == "--selection" && (value == "sort" || value == "top-k" || value == "proportional" || value == "tournament"))
+            {
+                settings.selection = (value == "sort" ? SELECTION_SORT : value == "proportional" ? SELECTION_PROPORTIONAL : value == "tournament" ? SELECTION_TOURNAMENT : SELECTION_TOP_K);
+            }
+            else if (argument == "--q0") { settings.q0 = std::min(1.0, std::max(0.0, std::stod(value))); }
+            else if (argument == "--track-best" && (value == "on" || value == "off")) { settings.track_best = (value == "on"); }
+            else if (argument == "--choice-info" && (value == "on" || value == "off")) { settings.choice_info = (value == "on"); }
+            else if (argument == "--parallel-local-search" && (value == "on" || value == "off")) { settings.parallel_local_search = (value == "on"); }
+            else if (argument == "--renumber" && (value == "on" || value == "off")) { settings.renumber = (value == "on"); }
+            else if (argument == "--huge-pages" && (value == "on" || value == "off")) { settings.huge_pages = (value == "on"); }
+            else if (argument == "--candidate-type" && (value == "nearest" || value == "quadrant")) { settings.quadrant_candidates = (value == "quadrant"); }
+            else
+            {
+                std::cout << "[Warning]: Unknown argument \"" << argument << "\"\n\t[\"Unknown argument\" fault masked]" << std::endl;
+            }
+        }
+        catch (const std::exception&)                                               /// Thrown by std::stoi() on malformed numbers
+        {
+            std::cout << "[Warning]: Invalid value \"" << value << "\" for argument \"" << argument << "\"\n\t[\"Invalid value\" fault masked]" << std::endl;
+        }
+    }
+    if (settings.n_points < 3) { settings.n_points = default_points(settings.algorithm); }
+                                                                                    /// Resolves the settings that were not given (or were invalid) to their default values
+    if (settings.iterations < 0) { settings.iterations = default_iterations(settings.algorithm); }
+    if (settings.seed < 0) { settings.seed = (long long)(random_seed() >> 1); }
+    return true;
+}
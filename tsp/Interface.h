@@ -10,9 +10,14 @@
 #pragma once
 
 #include "Common.h"
+#include "Instance.h"
+#include "Random.h"
 
 void print_tsp_tour_cost(const std::vector<long double> cost);
-void print_cities(const std::array<std::pair<int, int>, N_POINTS> cities);
-void print_row(const std::array<double, N_POINTS>& r);
-void print_matrix(const std::vector<std::array<double, N_POINTS>> matrix, const std::string matrix_name);
+void print_cities(const Instance& cities);
+void print_row(const std::vector<double>& r);
+void print_matrix(const std::vector<std::vector<double>> matrix, const std::string matrix_name);
 void print_acs_tsp(const std::vector<int> tsp_route);
+void print_usage(const std::string executable);
+bool parse_local_search(const std::string value, int& local_search);
+bool parse_arguments(int argc, char* argv[], Settings& settings);
@@ -0,0 +1,309 @@
+#include "KdTree.h"
+
+/**
+ * Builds the k-d tree of an instance.
+ *
+ * @param[in] cities the instance to be indexed
+ *
+ * @note the construction costs O(n log n). The coordinates are copied into the
+ *      tree in leaf order, so that scanning a leaf reads contiguous memory.
+ */
+KdTree::KdTree(const Instance& cities)
+{
+    const int n_points = cities.size();
+    order.resize(n_points);
+    std::iota(order.begin(), order.end(), 0);
+    px = cities.x;                                          /// During the construction the coordinates are indexed by city
+    py = cities.y;
+    leaf.resize(n_points);
+    removed.assign(n_points, 0);
+    nodes.reserve(4 * (n_points / KD_BUCKET_SIZE) + 1);
+    build(0, n_points, -1);
+
+    position.resize(n_points);
+    for (int p = 0; p < n_points; p += 1)                   /// After the construction the coordinates are indexed by position in `order`
+    {
+        position[order[p]] = p;
+        px[p] = cities.x[order[p]];
+        py[p] = cities.y[order[p]];
+    }
+}
+
+/**
+ * Builds a subtree of the k-d tree.
+ *
+ * @param[in] begin the first city (inclusive) of the subtree, with respect to `order`
+ * @param[in] end the last city (exclusive) of the subtree, with respect to `order`
+ * @param[in] parent the parent of the subtree, or -1 for the root
+ *
+ * @return the index of the root of the subtree inside `nodes`
+ *
+ * @note the cities are split at the median of the widest side of their bounding box.
+ */
+int KdTree::build(const int begin, const int end, const int parent)
+{
+    KdNode node = { begin, end, -1, -1, parent, end - begin,
+        std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity(),
+        -std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity() };
+    for (int p = begin; p < end; p += 1)                    /// Computes the bounding box of the subtree
+    {
+        node.min_x = std::min(node.min_x, px[order[p]]);
+        node.min_y = std::min(node.min_y, py[order[p]]);
+        node.max_x = std::max(node.max_x, px[order[p]]);
+        node.max_y = std::max(node.max_y, py[order[p]]);
+    }
+    const int idx = (int)nodes.size();
+    nodes.push_back(node);
+
+    if (end - begin <= KD_BUCKET_SIZE)                      /// The subtree is small enough to become a leaf
+    {
+        for (int p = begin; p < end; p += 1)
+        {
+            leaf[p] = idx;
+        }
+        return idx;
+    }
+
+    const int middle = begin + (end - begin) / 2;
+    const std::vector<double>& axis = (node.max_x - node.min_x >= node.max_y - node.min_y ? px : py);
+    std::nth_element(order.begin() + begin, order.begin() + middle, order.begin() + end,
+        [&axis](const int a, const int b) { return axis[a] < axis[b]; });
+                                                            /// Partitions the cities around the median in O(n)
+    const int left = build(begin, middle, idx);
+    const int right = build(middle, end, idx);
+    nodes[idx].left = left;                                 /// `nodes` may have been reallocated by the recursive calls
+    nodes[idx].right = right;
+    return idx;
+}
+
+/**
+ * Erases a city from the k-d tree, so that it is no longer returned by the queries.
+ *
+ * @param[in] city the city to be erased
+ *
+ * @note this costs O(log n), since only the counters of the ancestors of the city are updated.
+ */
+void KdTree::erase(const int city)
+{
+    const int p = position[city];
+    if (removed[p]) { return; }
+    removed[p] = 1;
+    for (int node = leaf[p]; node != -1; node = nodes[node].parent)
+    {
+        nodes[node].remaining -= 1;
+    }
+}
+
+/**
+ * Restores every erased city, so that the tree can be reused without being rebuilt.
+ *
+ * @note this costs O(n), while building the tree costs O(n log n).
+ */
+void KdTree::restore()
+{
+    std::fill(removed.begin(), removed.end(), 0);
+    for (KdNode& node : nodes)
+    {
+        node.remaining = node.end - node.begin;
+    }
+}
+
+/**
+ * Computes the quadrant of a point with respect to the point of a query.
+ *
+ * @param[in] dx the X coordinate of the point minus the X coordinate of the query
+ * @param[in] dy the Y coordinate of the point minus the Y coordinate of the query
+ *
+ * @return the quadrant (0 to 3, counter clockwise starting from the upper right one)
+ *
+ * @note every point on an axis belongs to exactly one quadrant. Duplicates of the query belong to the first quadrant.
+ */
+int quadrant_of(const double dx, const double dy)
+{
+    if (dx >= 0 && dy > 0) { return 0; }
+    if (dx < 0 && dy >= 0) { return 1; }
+    if (dx <= 0 && dy < 0) { return 2; }
+    if (dx > 0 && dy <= 0) { return 3; }
+    return 0;
+}
+
+/**
+ * Checks if a bounding box may hold points of a quadrant.
+ *
+ * @param[in] node the node of the bounding box
+ * @param[in] qx the X coordinate of the query
+ * @param[in] qy the Y coordinate of the query
+ * @param[in] quadrant the quadrant (0 to 3), or -1 for the whole plane
+ *
+ * @return false if the bounding box does not intersect the quadrant, else true
+ */
+bool intersects_quadrant(const KdNode& node, const double qx, const double qy, const int quadrant)
+{
+    switch (quadrant)
+    {
+        case 0: return node.max_x >= qx && node.max_y >= qy;
+        case 1: return node.min_x < qx && node.max_y >= qy;
+        case 2: return node.min_x <= qx && node.min_y < qy;
+        case 3: return node.max_x > qx && node.min_y <= qy;
+        default: return true;
+    }
+}
+
+/**
+ * Searches a subtree for the closest cities to a point.
+ *
+ * @param[in] node the root of the subtree
+ * @param[in] city the city of the query, which is never returned
+ * @param[in] qx the X coordinate of the query
+ * @param[in] qy the Y coordinate of the query
+ * @param[in] quadrant the quadrant around the query where the cities must lie (0 to 3), or -1 for the whole plane
+ * @param[in] count the number of closest cities requested
+ * @param[in, out] best_idx the closest cities found so far, in ascending distance
+ * @param[in, out] best_val the squared distances of the closest cities found so far
+ */
+void KdTree::search(const int node, const int city, const double qx, const double qy, const int quadrant, const int count, int* best_idx, double* best_val) const
+{
+    const KdNode& current = nodes[node];
+    if (current.left == -1)                                 /// Scan the leaf
+    {
+        for (int p = current.begin; p < current.end; p += 1)
+        {
+            if (removed[p] || order[p] == city) { continue; }
+            const double dx = px[p] - qx;
+            const double dy = py[p] - qy;
+            const double d = dx * dx + dy * dy;
+            if (d < best_val[count - 1] && (quadrant == -1 || quadrant_of(dx, dy) == quadrant))
+            {
+                int j = count - 1;                          /// Insert the city into the sorted list of the closest cities
+                while (j > 0 && best_val[j - 1] > d)
+                {
+                    best_idx[j] = best_idx[j - 1];
+                    best_val[j] = best_val[j - 1];
+                    j -= 1;
+                }
+                best_idx[j] = order[p];
+                best_val[j] = d;
+            }
+        }
+        return;
+    }
+
+    std::array<int, 2> children = { current.left, current.right };
+    std::array<double, 2> bound;                            /// The squared distance from the query to the bounding box of each child
+    for (int c = 0; c < 2; c += 1)
+    {
+        const KdNode& child = nodes[children[c]];
+        const double dx = std::max(std::max(child.min_x - qx, qx - child.max_x), 0.0);
+        const double dy = std::max(std::max(child.min_y - qy, qy - child.max_y), 0.0);
+        bound[c] = (child.remaining == 0 || !intersects_quadrant(child, qx, qy, quadrant) ? std::numeric_limits<double>::infinity() : dx * dx + dy * dy);
+    }
+    if (bound[1] < bound[0])                                /// Visit the closest child first to tighten the bound early
+    {
+        std::swap(children[0], children[1]);
+        std::swap(bound[0], bound[1]);
+    }
+    for (int c = 0; c < 2; c += 1)
+    {
+        if (bound[c] < best_val[count - 1])                 /// Prune the subtrees that cannot hold a closer city
+        {
+            search(children[c], city, qx, qy, quadrant, count, best_idx, best_val);
+        }
+    }
+}
+
+/**
+ * Searches the tree for the closest cities to a city, starting from the leaf that holds the city.
+ *
+ * @param[in] city the city of the query, which is never returned
+ * @param[in] quadrant the quadrant around the city where the cities must lie (0 to 3), or -1 for the whole plane
+ * @param[in] count the number of closest cities requested
+ * @param[in, out] best_idx an array of `count` elements, initialized to -1
+ * @param[in, out] best_val an array of `count` elements, initialized to infinity
+ *
+ * @note the closest cities usually lie in the leaf of the city or in a nearby subtree. Starting from
+ *      that leaf tightens the bound immediately, and the search stops climbing the tree as soon as
+ *      the ball around the city that holds the closest cities lies within the current subtree.
+ *
+ * @remark https://dl.acm.org/doi/10.1145/355744.355745
+ */
+void KdTree::query(const int city, const int quadrant, const int count, int* best_idx, double* best_val) const
+{
+    const int p = position[city];
+    const double qx = px[p];
+    const double qy = py[p];
+    int node = leaf[p];
+    search(node, city, qx, qy, quadrant, count, best_idx, best_val);
+    while (nodes[node].parent != -1)
+    {
+        const KdNode& current = nodes[node];
+        const double radius = best_val[count - 1];
+        if (qx - current.min_x > 0 && (qx - current.min_x) * (qx - current.min_x) > radius &&
+            current.max_x - qx > 0 && (current.max_x - qx) * (current.max_x - qx) > radius &&
+            qy - current.min_y > 0 && (qy - current.min_y) * (qy - current.min_y) > radius &&
+            current.max_y - qy > 0 && (current.max_y - qy) * (current.max_y - qy) > radius)
+        {
+            return;                                         /// No city outside this subtree can be closer
+        }
+        const KdNode& parent = nodes[current.parent];
+        const int sibling = (parent.left == node ? parent.right : parent.left);
+        const KdNode& other = nodes[sibling];
+        const double dx = std::max(std::max(other.min_x - qx, qx - other.max_x), 0.0);
+        const double dy = std::max(std::max(other.min_y - qy, qy - other.max_y), 0.0);
+        if (other.remaining > 0 && dx * dx + dy * dy < radius && intersects_quadrant(other, qx, qy, quadrant))
+        {
+            search(sibling, city, qx, qy, quadrant, count, best_idx, best_val);
+        }
+        node = current.parent;
+    }
+}
+
+/**
+ * Finds the closest city that has not been erased.
+ *
+ * @param[in] city the city of the query
+ *
+ * @return the closest city, or -1 if every other city has been erased
+ */
+int KdTree::nearest(const int city) const
+{
+    int best_idx = -1;
+    double best_val = std::numeric_limits<double>::infinity();
+    query(city, -1, 1, &best_idx, &best_val);
+    return best_idx;
+}
+
+/**
+ * Finds the two closest cities that have not been erased.
+ *
+ * @param[in] city the city of the query
+ *
+ * @return the closest and the second closest city. Any of them is -1 if not enough cities remain
+ */
+std::array<int, 2> KdTree::nearest_two(const int city) const
+{
+    std::array<int, 2> best_idx = { -1, -1 };
+    std::array<double, 2> best_val = { std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity() };
+    query(city, -1, 2, best_idx.data(), best_val.data());
+    return best_idx;
+}
+
+/**
+ * Finds the `count` closest cities that have not been erased.
+ *
+ * @param[in] city the city of the query
+ * @param[in] count the number of closest cities requested
+ * @param[in] quadrant the quadrant around the city where the cities must lie (0 to 3), or -1 for the whole plane
+ * @param[in, out] best_idx an array of `count` elements, where the closest cities are stored in ascending distance
+ * @param[in, out] best_val an array of `count` elements, where the squared Euclidean distances of those cities are stored
+ *
+ * @return the number of cities found, which is less than `count` if not enough cities remain
+ *
+ * @note the query is safe to be called concurrently by many threads, as long as no city is erased meanwhile.
+ */
+int KdTree::k_nearest(const int city, const int count, const int quadrant, int* best_idx, double* best_val) const
+{
+    std::fill(best_idx, best_idx + count, -1);
+    std::fill(best_val, best_val + count, std::numeric_limits<double>::infinity());
+    query(city, quadrant, count, best_idx, best_val);
+    return (int)(std::find(best_idx, best_idx + count, -1) - best_idx);
+}
@@ -0,0 +1,71 @@
+/**
+ * KdTree.h
+ *
+ * In this header file, we define a static spatial index
+ * over the cities of an instance. The index is a balanced
+ * 2-d tree whose leaves hold up to `KD_BUCKET_SIZE` cities.
+ * Cities can be erased from the index, and each node keeps
+ * the number of cities that remain in its subtree, so that
+ * empty subtrees are skipped by the queries. That way the
+ * nearest neighbor approaches find the closest unexplored
+ * city in roughly O(log n) instead of O(n). The same tree
+ * answers the k nearest neighbor queries (optionally
+ * restricted to a quadrant around the city) that build
+ * the candidate lists (see `Candidates.h`).
+ *
+ * @remark https://dl.acm.org/doi/10.1145/361002.361007
+ * @remark https://dl.acm.org/doi/10.5555/320176.320186
+ */
+
+#pragma once
+
+#include "Common.h"
+#include "Instance.h"
+
+/**
+ * A node of the k-d tree. Each node covers a contiguous range of the
+ * cities stored in the tree, along with the bounding box of that range.
+ */
+struct KdNode
+{
+    int begin;                                              /// The first city (inclusive) of the node, with respect to `KdTree::order`
+    int end;                                                /// The last city (exclusive) of the node, with respect to `KdTree::order`
+    int left;                                               /// The left child of the node, or -1 if the node is a leaf
+    int right;                                              /// The right child of the node, or -1 if the node is a leaf
+    int parent;                                             /// The parent of the node, or -1 if the node is the root
+    int remaining;                                          /// The number of cities in the subtree that have not been erased
+    double min_x, min_y, max_x, max_y;                      /// The bounding box of the cities in the subtree
+};
+
+/**
+ * A 2-d tree over the cities of an instance with deletion support.
+ *
+ * @note the tree is built once with the coordinates of the instance.
+ *      It must be rebuilt if the cities are reordered.
+ */
+class KdTree
+{
+public:
+    explicit KdTree(const Instance& cities);
+
+    void erase(const int city);
+    void restore();
+    int nearest(const int city) const;
+    std::array<int, 2> nearest_two(const int city) const;
+    int k_nearest(const int city, const int count, const int quadrant, int* best_idx, double* best_val) const;
+    int remaining() const { return nodes.front().remaining; }
+    int city_at(const int position) const { return order[position]; }
+
+private:
+    int build(const int begin, const int end, const int parent);
+    void search(const int node, const int city, const double qx, const double qy, const int quadrant, const int count, int* best_idx, double* best_val) const;
+    void query(const int city, const int quadrant, const int count, int* best_idx, double* best_val) const;
+
+    std::vector<KdNode> nodes;                              /// The nodes of the tree. The root is the first node
+    std::vector<int> order;                                 /// The cities sorted so that every node covers a contiguous range
+    std::vector<double> px;                                 /// The X coordinates of the cities, with respect to `order`
+    std::vector<double> py;                                 /// The Y coordinates of the cities, with respect to `order`
+    std::vector<int> position;                              /// The position of each city inside `order`
+    std::vector<int> leaf;                                  /// The leaf that holds each position of `order`
+    std::vector<char> removed;                              /// The flag of each position of `order` that marks erased cities
+};
@@ -0,0 +1,354 @@
+#include "Kernel.h"
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#include <immintrin.h>                                      /// AVX2 and AVX-512 intrinsics
+#define KERNEL_X86 1
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#define TARGET_AVX512 __attribute__((target("avx512f")))
+#elif defined(_MSC_VER) && defined(_M_X64)
+#include <immintrin.h>
+#include <intrin.h>                                         /// __cpuidex, _xgetbv
+#define KERNEL_X86 1
+#define TARGET_AVX2
+#define TARGET_AVX512
+#else
+#define KERNEL_X86 0
+#endif
+
+/**
+ * Detects the widest instruction set of the processor that the kernels support.
+ *
+ * @return `SIMD_AVX512`, `SIMD_AVX2` or `SIMD_SCALAR`
+ *
+ * @note the operating system must also save the wide registers on a context switch,
+ *      which the compiler builtins check along with the processor features.
+ */
+int detect_simd()
+{
+#if KERNEL_X86 && defined(_MSC_VER)
+    std::array<int, 4> info;
+    __cpuidex(info.data(), 7, 0);
+    const unsigned long long xcr0 = _xgetbv(0);
+    if ((info[1] & (1 << 16)) && (xcr0 & 0xE6) == 0xE6) { return SIMD_AVX512; }
+    if ((info[1] & (1 << 5)) && (xcr0 & 0x6) == 0x6) { return SIMD_AVX2; }
+#elif KERNEL_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) { return SIMD_AVX512; }
+    if (__builtin_cpu_supports("avx2")) { return SIMD_AVX2; }
+#endif
+    return SIMD_SCALAR;
+}
+
+int active_simd = SIMD_AUTO;                                /// The instruction set of the kernels, resolved on first use
+
+/**
+ * Fetches the instruction set of the kernels.
+ *
+ * @return the instruction set selected with `select_simd()`, or else the widest one of the processor
+ */
+int simd_level()
+{
+    if (active_simd == SIMD_AUTO) { active_simd = detect_simd(); }
+    return active_simd;
+}
+
+/**
+ * Selects the instruction set of the kernels.
+ *
+ * @param[in] level the requested instruction set (see `SIMD_*`), which is clamped to the widest one of the processor
+ */
+void select_simd(const int level)
+{
+    active_simd = (level == SIMD_AUTO ? detect_simd() : std::min(level, detect_simd()));
+}
+
+/**
+ * Names an instruction set.
+ *
+ * @param[in] level the instruction set (see `SIMD_*`)
+ *
+ * @return the name of the instruction set
+ */
+std::string simd_name(const int level)
+{
+    return (level == SIMD_AVX512 ? "AVX-512" : level == SIMD_AVX2 ? "AVX2" : "scalar");
+}
+
+/**
+ * Evaluates a block of edges with scalar instructions.
+ *
+ * @param[in] cities the dataset
+ * @param[in] from the city where the edges start
+ * @param[in] targets the cities where the edges end
+ * @param[in] pherormone the pherormone of each edge
+ * @param[in] count the number of edges
+ * @param[in, out] attractiveness the attractiveness of each edge
+ */
+void edge_attractiveness_scalar(const Instance& cities, const int from, const int* targets, const double* pherormone, const int count, double* attractiveness)
+{
+    for (int i = 0; i < count; i += 1)
+    {
+        const double eta = 1 / (double)tsp_hop_cost(cities, from, targets[i]).second;
+        attractiveness[i] = power(pherormone[i], ALPHA) * power(eta, BETA);
+    }
+}
+
+#if KERNEL_X86
+
+/**
+ * Raises 4 values to a small non-negative integer power.
+ *
+ * @param[in] value the bases
+ * @param[in] exponent the exponent
+ *
+ * @return `value` ^ `exponent`
+ */
+TARGET_AVX2 inline __m256d power_avx2(const __m256d value, const int exponent)
+{
+    __m256d result = _mm256_set1_pd(1.0);
+    for (int i = 0; i < exponent; i += 1) { result = _mm256_mul_pd(result, value); }
+    return result;
+}
+
+/**
+ * Raises 8 values to a small non-negative integer power.
+ *
+ * @param[in] value the bases
+ * @param[in] exponent the exponent
+ *
+ * @return `value` ^ `exponent`
+ */
+TARGET_AVX512 inline __m512d power_avx512(const __m512d value, const int exponent)
+{
+    __m512d result = _mm512_set1_pd(1.0);
+    for (int i = 0; i < exponent; i += 1) { result = _mm512_mul_pd(result, value); }
+    return result;
+}
+
+/**
+ * Evaluates a block of edges with AVX2 instructions, 4 edges at a time.
+ *
+ * @param[in] cities the dataset, whose metric must be `EUCLIDEAN`, `EUC_2D` or `CEIL_2D`
+ * @param[in] from the city where the edges start
+ * @param[in] targets the cities where the edges end
+ * @param[in] pherormone the pherormone of each edge
+ * @param[in] count the number of edges
+ * @param[in, out] attractiveness the attractiveness of each edge
+ */
+TARGET_AVX2 void edge_attractiveness_avx2(const Instance& cities, const int from, const int* targets, const double* pherormone, const int count, double* attractiveness)
+{
+    const __m256d from_x = _mm256_set1_pd(cities.x[from]);
+    const __m256d from_y = _mm256_set1_pd(cities.y[from]);
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d half = _mm256_set1_pd(0.5);
+    const __m256d all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+                                                            /// The gathers are masked with every lane set, so that they start from zero rather than an undefined register
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128i index = _mm_loadu_si128(reinterpret_cast<const __m128i*>(targets + i));
+        const __m256d dx = _mm256_sub_pd(_mm256_mask_i32gather_pd(_mm256_setzero_pd(), cities.x.data(), index, all, 8), from_x);
+        const __m256d dy = _mm256_sub_pd(_mm256_mask_i32gather_pd(_mm256_setzero_pd(), cities.y.data(), index, all, 8), from_y);
+        __m256d distance = _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy)));
+        if (cities.metric == Metric::EUC_2D) { distance = _mm256_floor_pd(_mm256_add_pd(distance, half)); }
+        else if (cities.metric == Metric::CEIL_2D) { distance = _mm256_ceil_pd(distance); }
+        const __m256d eta = _mm256_div_pd(one, distance);
+        const __m256d tau = _mm256_loadu_pd(pherormone + i);
+        _mm256_storeu_pd(attractiveness + i, _mm256_mul_pd(power_avx2(tau, ALPHA), power_avx2(eta, BETA)));
+    }
+    edge_attractiveness_scalar(cities, from, targets + i, pherormone + i, count - i, attractiveness + i);
+}
+
+/**
+ * Evaluates a block of edges with AVX-512 instructions, 8 edges at a time.
+ *
+ * @param[in] cities the dataset, whose metric must be `EUCLIDEAN`, `EUC_2D` or `CEIL_2D`
+ * @param[in] from the city where the edges start
+ * @param[in] targets the cities where the edges end
+ * @param[in] pherormone the pherormone of each edge
+ * @param[in] count the number of edges
+ * @param[in, out] attractiveness the attractiveness of each edge
+ *
+ * @note the remainder of the block is evaluated with a masked iteration instead of the scalar kernel.
+ *      The squares are added without a fused multiply-add, so the lengths match the scalar kernel bit for bit.
+ */
+TARGET_AVX512 void edge_attractiveness_avx512(const Instance& cities, const int from, const int* targets, const double* pherormone, const int count, double* attractiveness)
+{
+    const __m512d from_x = _mm512_set1_pd(cities.x[from]);
+    const __m512d from_y = _mm512_set1_pd(cities.y[from]);
+    const __m512d one = _mm512_set1_pd(1.0);
+    const __m512d half = _mm512_set1_pd(0.5);
+    for (int i = 0; i < count; i += 8)
+    {
+        const __mmask8 mask = (count - i >= 8 ? (__mmask8)0xFF : (__mmask8)((1u << (count - i)) - 1));
+        const __m256i index = _mm512_maskz_extracti64x4_epi64((__mmask8)0xF, _mm512_maskz_loadu_epi32((__mmask16)mask, targets + i), 0);
+                                                            /// A 256-bit masked load would need AVX-512VL. The zero masked forms
+                                                            /// below start from zero rather than an undefined register
+
+        const __m512d dx = _mm512_sub_pd(_mm512_mask_i32gather_pd(from_x, mask, index, cities.x.data(), 8), from_x);
+        const __m512d dy = _mm512_sub_pd(_mm512_mask_i32gather_pd(from_y, mask, index, cities.y.data(), 8), from_y);
+        __m512d distance = _mm512_maskz_sqrt_pd((__mmask8)0xFF, _mm512_add_pd(_mm512_mul_pd(dx, dx), _mm512_mul_pd(dy, dy)));
+        if (cities.metric == Metric::EUC_2D) { distance = _mm512_maskz_roundscale_pd((__mmask8)0xFF, _mm512_add_pd(distance, half), _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+        else if (cities.metric == Metric::CEIL_2D) { distance = _mm512_maskz_roundscale_pd((__mmask8)0xFF, distance, _MM_FROUND_TO_POS_INF | _MM_FROUND_NO_EXC); }
+        const __m512d eta = _mm512_div_pd(one, distance);
+        const __m512d tau = _mm512_maskz_loadu_pd(mask, pherormone + i);
+        _mm512_mask_storeu_pd(attractiveness + i, mask, _mm512_mul_pd(power_avx512(tau, ALPHA), power_avx512(eta, BETA)));
+    }
+}
+
+/**
+ * Evaluates a block of edges of known length with AVX2 instructions, 4 edges at a time.
+ *
+ * @param[in] pherormone the pherormone of each edge
+ * @param[in] distances the length of each edge
+ * @param[in] count the number of edges
+ * @param[in, out] attractiveness the attractiveness of each edge
+ */
+TARGET_AVX2 void candidate_attractiveness_avx2(const double* pherormone, const double* distances, const int count, double* attractiveness)
+{
+    const __m256d one = _mm256_set1_pd(1.0);
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m256d eta = _mm256_div_pd(one, _mm256_loadu_pd(distances + i));
+        _mm256_storeu_pd(attractiveness + i, _mm256_mul_pd(power_avx2(_mm256_loadu_pd(pherormone + i), ALPHA), power_avx2(eta, BETA)));
+    }
+    for (; i < count; i += 1)
+    {
+        attractiveness[i] = power(pherormone[i], ALPHA) * power(1 / distances[i], BETA);
+    }
+}
+
+/**
+ * Evaluates a block of edges of known length with AVX-512 instructions, 8 edges at a time.
+ *
+ * @param[in] pherormone the pherormone of each edge
+ * @param[in] distances the length of each edge
+ * @param[in] count the number of edges
+ * @param[in, out] attractiveness the attractiveness of each edge
+ */
+TARGET_AVX512 void candidate_attractiveness_avx512(const double* pherormone, const double* distances, const int count, double* attractiveness)
+{
+    const __m512d one = _mm512_set1_pd(1.0);
+    for (int i = 0; i < count; i += 8)
+    {
+        const __mmask8 mask = (count - i >= 8 ? (__mmask8)0xFF : (__mmask8)((1u << (count - i)) - 1));
+        const __m512d eta = _mm512_div_pd(one, _mm512_mask_loadu_pd(one, mask, distances + i));
+        _mm512_mask_storeu_pd(attractiveness + i, mask, _mm512_mul_pd(power_avx512(_mm512_maskz_loadu_pd(mask, pherormone + i), ALPHA), power_avx512(eta, BETA)));
+    }
+}
+
+#endif
+
+/**
+ * Evaluates a block of edges that start at the same city.
+ *
+ * @param[in] cities the dataset
+ * @param[in] from the city where the edges start
+ * @param[in] targets the cities where the edges end
+ * @param[in] pherormone the pherormone of each edge
+ * @param[in] count the number of edges
+ * @param[in, out] attractiveness the attractiveness tau^ALPHA * eta^BETA of each edge
+ * @param[in] level the instruction set of the kernel (see `SIMD_*`)
+ *
+ * @note the lengths of the edges are computed from the coordinates inside the kernel.
+ */
+void edge_attractiveness(const Instance& cities, const int from, const int* targets, const double* pherormone, const int count, double* attractiveness, const int level)
+{
+#if KERNEL_X86
+    const bool vectorizes = (cities.metric == Metric::EUCLIDEAN || cities.metric == Metric::EUC_2D || cities.metric == Metric::CEIL_2D);
+    if (vectorizes && level == SIMD_AVX512) { edge_attractiveness_avx512(cities, from, targets, pherormone, count, attractiveness); return; }
+    if (vectorizes && level == SIMD_AVX2) { edge_attractiveness_avx2(cities, from, targets, pherormone, count, attractiveness); return; }
+#endif
+    edge_attractiveness_scalar(cities, from, targets, pherormone, count, attractiveness);
+}
+
+/**
+ * Evaluates a block of edges whose lengths are known, such as the edges to the candidates of a city.
+ *
+ * @param[in] pherormone the pherormone of each edge
+ * @param[in] distances the length of each edge
+ * @param[in] count the number of edges
+ * @param[in, out] attractiveness the attractiveness tau^ALPHA * eta^BETA of each edge
+ * @param[in] level the instruction set of the kernel (see `SIMD_*`)
+ */
+void candidate_attractiveness(const double* pherormone, const double* distances, const int count, double* attractiveness, const int level)
+{
+#if KERNEL_X86
+    if (level == SIMD_AVX512) { candidate_attractiveness_avx512(pherormone, distances, count, attractiveness); return; }
+    if (level == SIMD_AVX2) { candidate_attractiveness_avx2(pherormone, distances, count, attractiveness); return; }
+#endif
+    for (int i = 0; i < count; i += 1)
+    {
+        attractiveness[i] = power(pherormone[i], ALPHA) * power(1 / distances[i], BETA);
+    }
+}
+
+/**
+ * Finds the 2 closest cities to a city among a contiguous range of cities.
+ *
+ * @param[in] cities the dataset
+ * @param[in] from the city whose neighbors are searched
+ * @param[in] first the first city of the range
+ * @param[in] last the city after the last city of the range
+ *
+ * @return the 2 closest cities of the range, along with their distances
+ *
+ * @note for the geometric metrics, the squared Euclidean distance orders the cities like the
+ *      metric, so no square root is taken. Each of the `NEAREST_LANES` lanes keeps its own top-2
+ *      state and updates it with selects instead of branches, so the loop vectorizes over the
+ *      coordinate arrays. The lanes are merged at the end. The other metrics are scanned in order.
+ */
+NearestTwo nearest_two(const Instance& cities, const int from, const int first, const int last)
+{
+    constexpr int NEAREST_LANES = 8;                        /// The number of lanes, which fill an AVX-512 register of doubles
+    NearestTwo nearest;
+    int j = first;
+    if (cities.is_geometric())
+    {
+        alignas(PHERORMONE_ALIGNMENT) double best[NEAREST_LANES], second[NEAREST_LANES];
+        alignas(PHERORMONE_ALIGNMENT) int best_city[NEAREST_LANES], second_city[NEAREST_LANES];
+        for (int l = 0; l < NEAREST_LANES; l += 1)
+        {
+            best[l] = second[l] = std::numeric_limits<double>::infinity();
+            best_city[l] = second_city[l] = -1;
+        }
+        const double* x = cities.x.data();
+        const double* y = cities.y.data();
+        const double from_x = x[from];
+        const double from_y = y[from];
+        for (; j + NEAREST_LANES <= last; j += NEAREST_LANES)
+        {
+#pragma omp simd aligned(best, second, best_city, second_city : PHERORMONE_ALIGNMENT)
+            for (int l = 0; l < NEAREST_LANES; l += 1)
+            {
+                const double dx = x[j + l] - from_x;
+                const double dy = y[j + l] - from_y;
+                const double distance = dx * dx + dy * dy;
+                const bool is_best = distance < best[l];    /// A lane sees its cities in ascending order, so ties keep the smaller city
+                const bool is_second = distance < second[l];
+                second[l] = (is_best ? best[l] : is_second ? distance : second[l]);
+                second_city[l] = (is_best ? best_city[l] : is_second ? j + l : second_city[l]);
+                best[l] = (is_best ? distance : best[l]);
+                best_city[l] = (is_best ? j + l : best_city[l]);
+            }
+        }
+        for (int l = 0; l < NEAREST_LANES; l += 1)
+        {
+            if (best_city[l] >= 0) { nearest.offer(best[l], best_city[l]); }
+            if (second_city[l] >= 0) { nearest.offer(second[l], second_city[l]); }
+        }
+        for (; j < last; j += 1)
+        {
+            const double dx = x[j] - from_x;
+            const double dy = y[j] - from_y;
+            nearest.offer(dx * dx + dy * dy, j);
+        }
+        return nearest;
+    }
+    for (; j < last; j += 1)
+    {
+        nearest.offer((double)tsp_hop_cost(cities, from, j).second, j);
+    }
+    return nearest;
+}
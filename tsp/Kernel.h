@@ -0,0 +1,90 @@
+/**
+ * Kernel.h
+ *
+ * In this header file, we define the vectorized kernels
+ * that evaluate the edges an ant may follow. The kernels
+ * compute the attractiveness tau^ALPHA * eta^BETA of a
+ * whole block of edges in one pass, where tau is the
+ * pherormone of an edge and eta = 1 / d is the inverse of
+ * its length. The coordinates of the cities are stored as
+ * separate arrays (see `Instance.h`), so the kernels load
+ * 4 (AVX2) or 8 (AVX-512) cities at once with a gather.
+ * The instruction set is detected at run time, so the
+ * same executable runs on any x86-64 processor, and the
+ * scalar kernels are used on other architectures and for
+ * the metrics that do not vectorize (ATT, GEO, EXPLICIT).
+ * The nearest neighbor kernel (`nearest_two`) scans the
+ * coordinates in contiguous blocks instead, so it is left
+ * to the compiler, with one top-2 state per vector lane.
+ *
+ * @remark https://www.intel.com/content/www/us/en/docs/intrinsics-guide/index.html
+ */
+
+#pragma once
+
+#include "Common.h"
+#include "Distance.h"
+#include "Instance.h"
+
+/**
+ * Raises a value to a small non-negative integer power.
+ *
+ * @param[in] value the base
+ * @param[in] exponent the exponent
+ *
+ * @return `value` ^ `exponent`
+ *
+ * @note the exponents are compile time constants (`ALPHA` and `BETA`), so the loop is unrolled.
+ */
+inline double power(const double value, const int exponent)
+{
+    double result = 1.0;
+    for (int i = 0; i < exponent; i += 1) { result *= value; }
+    return result;
+}
+
+/**
+ * The 2 closest cities to a city, padded to a cache line so that the copies of the threads never share one.
+ *
+ * @note the cities are ordered by distance and then by index, so merging the states of any
+ *      partition of the cities yields the same 2 cities.
+ */
+struct alignas(PHERORMONE_ALIGNMENT) NearestTwo
+{
+    double distance[2] = { std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity() };
+                                                            /// The distance to the closest and to the second closest city, squared for the geometric metrics
+    int city[2] = { -1, -1 };                               /// The closest and the second closest city, or -1
+
+    void offer(const double value, const int candidate)     /// Offers a city to the state
+    {
+        if (value < distance[1] || (value == distance[1] && candidate < city[1]))
+        {
+            if (value < distance[0] || (value == distance[0] && candidate < city[0]))
+            {
+                distance[1] = distance[0];
+                city[1] = city[0];
+                distance[0] = value;
+                city[0] = candidate;
+            }
+            else
+            {
+                distance[1] = value;
+                city[1] = candidate;
+            }
+        }
+    }
+    void merge(const NearestTwo& other)                     /// Merges the state of another part of the cities
+    {
+        for (int k = 0; k < 2; k += 1)
+        {
+            if (other.city[k] >= 0) { offer(other.distance[k], other.city[k]); }
+        }
+    }
+};
+
+int simd_level();
+void select_simd(const int level);
+std::string simd_name(const int level);
+void edge_attractiveness(const Instance& cities, const int from, const int* targets, const double* pherormone, const int count, double* attractiveness, const int level = simd_level());
+NearestTwo nearest_two(const Instance& cities, const int from, const int first, const int last);
+void candidate_attractiveness(const double* pherormone, const double* distances, const int count, double* attractiveness, const int level = simd_level());
@@ -0,0 +1,263 @@
+#include "LinKernighan.h"
+
+/**
+ * Prepares the local search over a TSP route.
+ *
+ * @param[in] cities the dataset
+ * @param[in] candidates the candidate lists of `cities` (see `Candidates.h`)
+ * @param[in, out] tour the TSP route to be improved (see `Tour.h`)
+ */
+LinKernighan::LinKernighan(const Instance& cities, const CandidateList& candidates, Tour& tour)
+    : cities(cities), candidates(candidates), tour(tour), n_points(tour.size()), queued(tour.size(), 1), route_cost(0.0)
+{
+    for (int i = 0, city = 0; i < n_points; i += 1, city = tour.next(city))
+    {
+        queue.push_back(city);                              /// Examine the cities in route order
+        route_cost += distance(city, tour.next(city));
+    }
+}
+
+/**
+ * Applies a flip to the route and records it.
+ *
+ * @param[in] a the first city of the first edge
+ * @param[in] b the second city of the first edge
+ * @param[in] c the first city of the second edge
+ * @param[in] d the second city of the second edge
+ *
+ * @note the flip replaces the edges (a, b) and (c, d) with the edges (a, c) and (b, d) (see Tour::flip()).
+ */
+void LinKernighan::flip(const int a, const int b, const int c, const int d)
+{
+    tour.flip(a, b, c, d);
+    flips.push_back({ a, b, c, d });
+}
+
+/**
+ * Undoes the most recent flips, until `size` flips remain recorded.
+ *
+ * @param[in] size the number of flips to keep
+ */
+void LinKernighan::undo(const size_t size)
+{
+    while (flips.size() > size)
+    {
+        const Flip& last = flips.back();
+        tour.flip(last.a, last.c, last.b, last.d);
+                                                            /// Replace the edges (a, c) and (b, d) with the edges (a, b) and (c, d)
+        flips.pop_back();
+    }
+}
+
+/**
+ * Marks a city to be examined.
+ *
+ * @param[in] city the city whose don't look bit is reset
+ */
+void LinKernighan::push(const int city)
+{
+    if (!queued[city]) { queued[city] = 1; queue.push_back(city); }
+}
+
+/**
+ * Extends the move under construction by one flip.
+ *
+ * @param[in] depth the number of flips of the move so far
+ * @param[in] t1 the city where the move started
+ * @param[in] t2 the city whose edge to `t1` is the next to be removed
+ * @param[in] gain the cost of the removed edges minus the cost of the added edges, excluding the edge (t1, t2)
+ * @param[in] best_gain the best gain of a closed route found along the move so far
+ * @param[in] best_size the number of recorded flips when `best_gain` was found
+ *
+ * @return true if the route was improved, in which case the move is kept up to its best closed route
+ *
+ * @remark each flip removes the edge (t1, t2) and an edge (t3, t4), where `t3` is a candidate of `t2`,
+ *      and adds the edges (t2, t3) and (t4, t1). The edge (t2, t3) is kept by the deeper flips, while
+ *      the edge (t4, t1) is the one that closes the route and is removed by the next flip.
+ */
+bool LinKernighan::step(const int depth, const int t1, const int t2, const double gain, double best_gain, size_t best_size)
+{
+    if (depth < LK_DEPTH)
+    {
+        const bool t1_after_t2 = (tour.next(t2) == t1);
+        std::array<std::pair<double, std::array<int, 2>>, LK_MAX_CANDIDATES> options;
+                                                            /// Declare an array to store the alternatives of this level, along with their look-ahead value
+        int n_options = 0;
+        const int* neighbors = candidates.neighbors_of(t2);
+        const double* distances = candidates.distances_of(t2);
+        for (int j = 0; j < candidates.k && n_options < LK_MAX_CANDIDATES; j += 1)
+        {
+            const int t3 = neighbors[j];
+            if (gain - distances[j] <= 0) { break; }        /// The partial gain must remain positive
+            if (t3 == t1 || t3 == tour.next(t2) || t3 == tour.prev(t2)) { continue; }
+            const int t4 = (t1_after_t2 ? tour.next(t3) : tour.prev(t3));
+                                                            /// The edge (t3, t4) must be removed on the same side as (t2, t1) to keep the route closed
+            bool is_added = false;
+            for (const std::pair<int, int>& edge : added)
+            {
+                is_added = is_added || (edge.first == t3 && edge.second == t4) || (edge.first == t4 && edge.second == t3);
+            }
+            if (is_added) { continue; }
+            options[n_options++] = std::make_pair(distance(t3, t4) - distances[j], std::array<int, 2>{ t3, t4 });
+        }
+        std::sort(options.begin(), options.begin() + n_options, [](const auto& lhs, const auto& rhs) { return lhs.first > rhs.first; });
+                                                            /// Try the alternatives that remove the longest edge for the shortest added edge first
+        const int breadth = std::min(n_options, depth < (int)LK_BREADTH.size() ? LK_BREADTH[depth] : 1);
+        for (int i = 0; i < breadth; i += 1)
+        {
+            const int t3 = options[i].second[0];
+            const int t4 = options[i].second[1];
+            flip(t2, t1, t3, t4);
+            added.emplace_back(t2, t3);
+            const double next_gain = gain - distance(t2, t3) + distance(t3, t4);
+            const double closed_gain = next_gain - distance(t4, t1);
+            const bool is_best = (closed_gain > best_gain);
+            if (step(depth + 1, t1, t4, next_gain, (is_best ? closed_gain : best_gain), (is_best ? flips.size() : best_size))) { return true; }
+            added.pop_back();
+            undo(flips.size() - 1);
+        }
+    }
+    if (best_gain > 1e-9)                                   /// Keep the move up to its best closed route
+    {
+        undo(best_size);
+        route_cost -= best_gain;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Searches for an improving move that starts at a city.
+ *
+ * @param[in] t1 the city where the move starts
+ *
+ * @return true if the route was improved
+ */
+bool LinKernighan::improve(const int t1)
+{
+    for (int side = 0; side < 2; side += 1)                 /// Try to remove the edge to the successor first and the predecessor second
+    {
+        const int t2 = (side == 0 ? tour.next(t1) : tour.prev(t1));
+        const size_t size = flips.size();
+        added.clear();
+        if (step(0, t1, t2, distance(t1, t2), 0.0, size))
+        {
+            for (size_t i = size; i < flips.size(); i += 1) /// Reset the don't look bits of the endpoints of the move
+            {
+                push(flips[i].a);
+                push(flips[i].b);
+                push(flips[i].c);
+                push(flips[i].d);
+            }
+            if (!journaling) { flips.clear(); }             /// The flips are only recorded to undo the kicks
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Improves the route until no city of the queue yields an improving move.
+ *
+ * @param[in] deadline the time point after which the search is stopped, even if the route is not locally optimal
+ *
+ * @return the number of improving moves applied
+ */
+int LinKernighan::optimize(const std::chrono::time_point<std::chrono::system_clock> deadline)
+{
+    int moves = 0;
+    if (n_points < 8) { return 0; }                         /// The flips of a move must not overlap
+    while (!queue.empty() && std::chrono::system_clock::now() < deadline)
+    {
+        const int t1 = queue.front();
+        queue.pop_front();
+        queued[t1] = 0;
+        if (improve(t1))
+        {
+            push(t1);
+            moves += 1;
+        }
+    }
+    return moves;
+}
+
+/**
+ * Applies a double bridge kick to a random part of the route.
+ *
+ * @param[in, out] gen the random generator
+ *
+ * @remark the kick selects 2 consecutive segments B and C of up to `KICK_SEGMENT` cities, and
+ *      turns the route A B C D into A C B D. This move can not be undone by a sequence of improving
+ *      2-opt or 3-opt moves, so it drives the search out of the current local optimum. It is applied as
+ *      3 flips: (B C) is reversed and then each of the reversed segments is reversed back.
+ */
+void LinKernighan::kick(Xoshiro256& gen)
+{
+    std::uniform_int_distribution<int> start_dist(0, n_points - 1);
+    std::uniform_int_distribution<int> length_dist(1, std::max(1, std::min(KICK_SEGMENT, (n_points - 2) / 2)));
+    const int length_b = length_dist(gen);
+    const int length_c = length_dist(gen);
+    auto walk = [&](int city, const int steps)              /// Follow the successors of a city
+    {
+        for (int i = 0; i < steps; i += 1) { city = tour.next(city); }
+        return city;
+    };
+    const int p = start_dist(gen);
+    const int b1 = tour.next(p);
+    const int b2 = walk(b1, length_b - 1);
+    const int c1 = tour.next(b2);
+    const int c2 = walk(c1, length_c - 1);
+    const int q = tour.next(c2);
+    route_cost += distance(p, c1) + distance(c2, b1) + distance(b2, q) - distance(p, b1) - distance(b2, c1) - distance(c2, q);
+    flip(p, b1, c2, q);                                     /// A B C D -> A C' B' D
+    if (c1 != c2) { flip(p, c2, c1, b2); }                  /// A C' B' D -> A C B' D
+    if (b1 != b2) { flip(c2, b2, b1, q); }                  /// A C B' D -> A C B D
+    for (const int city : { p, b1, b2, c1, c2, q })
+    {
+        push(city);
+    }
+}
+
+/**
+ * Iterates kicks and local searches, keeping the kicks that lead to a shorter route.
+ *
+ * @param[in] kicks the maximum number of kicks
+ * @param[in] deadline the time point after which no kick is applied
+ * @param[in] seed the seed of the run
+ *
+ * @return the number of kicks applied and the number of kicks that led to a shorter route
+ *
+ * @note a kick that does not lead to a shorter route is undone along with the flips of the local
+ *      search that followed it. This costs as much as the flips themselves, instead of the O(n)
+ *      that storing a copy of the route would cost.
+ */
+std::pair<int, int> LinKernighan::perturb(const int kicks, const std::chrono::time_point<std::chrono::system_clock> deadline, const std::uint64_t seed)
+{
+    Xoshiro256 gen = random_stream(seed, STREAM_MAIN);      /// The stream of the kicks (see `Random.h`)
+    int applied = 0;
+    int accepted = 0;
+    if (n_points < 8) { return std::make_pair(0, 0); }
+    journaling = true;
+    for (; applied < kicks && std::chrono::system_clock::now() < deadline; applied += 1)
+    {
+        const double previous_cost = route_cost;
+        flips.clear();
+        kick(gen);
+        optimize(deadline);
+        if (route_cost < previous_cost - 1e-9)
+        {
+            accepted += 1;
+            continue;
+        }
+        undo(0);                                            /// Restore the route before the kick
+        route_cost = previous_cost;
+        while (!queue.empty())                              /// The search may have been stopped by the deadline
+        {
+            queued[queue.front()] = 0;
+            queue.pop_front();
+        }
+    }
+    flips.clear();
+    journaling = false;
+    return std::make_pair(applied, accepted);
+}
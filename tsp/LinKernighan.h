@@ -0,0 +1,75 @@
+/**
+ * LinKernighan.h
+ *
+ * In this header file, we define a variable depth local
+ * search in the spirit of Lin - Kernighan. An improving
+ * move is built as a sequence of up to `LK_DEPTH` 2-opt
+ * flips, where each flip must keep the partial gain positive
+ * and only the candidate neighbors of a city are considered
+ * (see `Candidates.h`). The first levels of the sequence try
+ * several alternatives (see `LK_BREADTH`), while the deeper
+ * levels are greedy. Once the route is locally optimal, the
+ * search is restarted from small double bridge kicks (which
+ * move at most `KICK_SEGMENT` cities), and a kick is undone
+ * when it does not lead to a shorter route, until the time
+ * budget or the number of kicks is exhausted.
+ *
+ * @remark https://www.cs.princeton.edu/~bwk/btsp.pdf
+ * @remark https://www.math.uwaterloo.ca/~bico/papers/clk_ijoc.pdf
+ * @remark https://www.cs.ubc.ca/~hutter/previous-earg/EmpAlgReadingGroup/TSP-JohMcg97.pdf
+ */
+
+#pragma once
+
+#include "Common.h"
+#include "Distance.h"
+#include "Instance.h"
+#include "Candidates.h"
+#include "LocalSearch.h"
+#include "Tour.h"
+#include "Random.h"
+
+/**
+ * A flip of the route, which replaced the edges (a, b) and (c, d) with the edges (a, c) and (b, d).
+ */
+struct Flip
+{
+    int a, b, c, d;
+};
+
+/**
+ * The Lin - Kernighan style local search over a TSP route.
+ *
+ * @note the route is improved in place. Every flip applied to the route is
+ *      recorded, so that a whole chain of flips (or a kick along with the
+ *      flips that followed it) can be undone in reverse order.
+ */
+class LinKernighan
+{
+public:
+    LinKernighan(const Instance& cities, const CandidateList& candidates, Tour& tour);
+
+    int optimize(const std::chrono::time_point<std::chrono::system_clock> deadline);
+    std::pair<int, int> perturb(const int kicks, const std::chrono::time_point<std::chrono::system_clock> deadline, const std::uint64_t seed);
+    double cost() const { return route_cost; }
+
+private:
+    double distance(const int a, const int b) const { return (double)tsp_hop_cost(cities, a, b).second; }
+    void flip(const int a, const int b, const int c, const int d);
+    void undo(const size_t size);
+    bool step(const int depth, const int t1, const int t2, const double gain, double best_gain, size_t best_size);
+    bool improve(const int t1);
+    void kick(Xoshiro256& gen);
+    void push(const int city);
+
+    const Instance& cities;                                 /// The dataset
+    const CandidateList& candidates;                        /// The candidate lists of `cities`
+    Tour& tour;                                             /// The TSP route that is improved
+    const int n_points;                                     /// The number of cities
+    std::vector<Flip> flips;                                /// The flips applied since the last accepted change, in order
+    std::vector<std::pair<int, int>> added;                 /// The edges added by the move under construction
+    std::deque<int> queue;                                  /// The queue of the cities that are to be examined
+    std::vector<char> queued;                               /// The flag of each city inside `queue`. Its negation is the "don't look bit" of each city
+    double route_cost;                                      /// The cost of `tour`
+    bool journaling = false;                                /// If true, the flips of the improving moves are kept recorded, so that they can be undone
+};
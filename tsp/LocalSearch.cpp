@@ -0,0 +1,495 @@
+#include "LocalSearch.h"
+
+/**
+ * Improves a TSP route with 2-opt moves until it is 2-optimal with respect to the candidate lists.
+ *
+ * @param[in] cities the dataset
+ * @param[in] candidates the candidate lists of `cities` (see `Candidates.h`)
+ * @param[in, out] tour the TSP route to be improved (see `Tour.h`)
+ *
+ * @return the number of improving moves applied
+ *
+ * @remark 2-opt with neighbor lists and don't look bits:
+ *      - Push all the cities into a queue
+ *      - Repeat:
+ *      -   Pop a city `a` from the queue
+ *      -   For each of the 2 tour neighbors `b` of `a`:
+ *      -     For each candidate `c` of `a` with d(a, c) < d(a, b):
+ *      -       Let `d` be the tour neighbor of `c` on the same side as `b` is to `a`
+ *      -       If replacing (a, b) and (c, d) with (a, c) and (b, d) shortens the route:
+ *      -         Reverse the path between them and push `a`, `b`, `c` and `d` into the queue
+ *      - Until the queue is empty
+ *
+ * @note since the candidates of a city are sorted in ascending distance, the scan of
+ *      the candidates stops as soon as d(a, c) >= d(a, b), because no improving move
+ *      can be found with a further candidate (the gain criterion of Lin - Kernighan).
+ */
+int two_opt(const Instance& cities, const CandidateList& candidates, Tour& tour)
+{
+    const int n_points = tour.size();
+    if (n_points < 5) { return 0; }                         /// Every route of 4 cities or less is 2-optimal
+    std::deque<int> queue;                                  /// Declare the queue of the cities that are to be examined
+    std::vector<char> queued(n_points, 1);                  /// Declare a vector to flag the cities inside `queue`. Its negation is the "don't look bit" of each city
+    for (int i = 0, city = 0; i < n_points; i += 1, city = tour.next(city))
+    {
+        queue.push_back(city);                              /// Examine the cities in route order
+    }
+    auto push = [&](const int city)
+    {
+        if (!queued[city]) { queued[city] = 1; queue.push_back(city); }
+    };
+
+    int moves = 0;
+    while (!queue.empty())
+    {
+        const int a = queue.front();
+        queue.pop_front();
+        queued[a] = 0;
+        bool improved = false;
+        for (int side = 0; side < 2 && !improved; side += 1)/// Try the successor first and the predecessor second
+        {
+            const int b = (side == 0 ? tour.next(a) : tour.prev(a));
+            const double d_ab = (double)tsp_hop_cost(cities, a, b).second;
+            const int* neighbors = candidates.neighbors_of(a);
+            const double* distances = candidates.distances_of(a);
+            for (int j = 0; j < candidates.k; j += 1)
+            {
+                const int c = neighbors[j];
+                const double d_ac = distances[j];
+                if (d_ac >= d_ab) { break; }                /// No further candidate can yield a positive gain
+                const int d = (side == 0 ? tour.next(c) : tour.prev(c));
+                if (c == b || d == a) { continue; }
+                const double delta = d_ac + (double)tsp_hop_cost(cities, b, d).second - d_ab - (double)tsp_hop_cost(cities, c, d).second;
+                if (delta < -1e-9)                          /// Apply the improving move
+                {
+                    tour.flip(a, b, c, d);
+                    push(a);
+                    push(b);
+                    push(c);
+                    push(d);
+                    moves += 1;
+                    improved = true;
+                    break;
+                }
+            }
+        }
+    }
+    return moves;
+}
+
+/**
+ * Moves a segment of the route between 2 other cities, as a sequence of 2-opt moves.
+ *
+ * @param[in, out] tour the TSP route (see `Tour.h`)
+ * @param[in] p the city before the segment, on the side of `s1`
+ * @param[in] s1 the first end of the segment
+ * @param[in] s2 the second end of the segment
+ * @param[in] n the city after the segment, on the side of `s2`
+ * @param[in] c the city that becomes the neighbor of `s1`
+ * @param[in] d the city that becomes the neighbor of `s2`, which must be a tour neighbor of `c`
+ *
+ * @note the segment is moved with 2 flips if it ends up reversed, else with a third flip that reverses it back.
+ */
+void move_segment(Tour& tour, const int p, const int s1, const int s2, const int n, const int c, const int d)
+{
+    const bool forward = (tour.next(p) == s1);
+    if ((forward ? tour.next(c) : tour.prev(c)) == d)
+    {                                                       /// p s1 .. s2 n .. c d  ->  p c .. n s2 .. s1 d  ->  p n .. c s2 .. s1 d  ->  p n .. c s1 .. s2 d
+        tour.flip(p, s1, c, d);
+        tour.flip(p, c, n, s2);
+        tour.flip(c, s2, s1, d);
+    }
+    else
+    {                                                       /// p s1 .. s2 n .. d c  ->  p d .. n s2 .. s1 c  ->  p n .. d s2 .. s1 c
+        tour.flip(p, s1, d, c);
+        tour.flip(p, d, n, s2);
+    }
+}
+
+/**
+ * Improves a TSP route with Or-opt moves until it is Or-optimal with respect to the candidate lists.
+ *
+ * @param[in] cities the dataset
+ * @param[in] candidates the candidate lists of `cities` (see `Candidates.h`)
+ * @param[in, out] tour the TSP route to be improved (see `Tour.h`)
+ *
+ * @return the number of improving moves applied
+ *
+ * @remark Or-opt with neighbor lists and don't look bits:
+ *      - Push all the cities into a queue
+ *      - Repeat:
+ *      -   Pop a city `s1` from the queue
+ *      -   For each segment `s1` ... `s2` of 1 to `OR_OPT_SEGMENT` cities that starts at `s1`, in both directions:
+ *      -     Let `p` and `n` be the cities before and after the segment
+ *      -     For each candidate `c` of `s1` with d(s1, c) < d(p, s1) + d(s2, n) - d(p, n):
+ *      -       For each tour neighbor `d` of `c`:
+ *      -         If moving the segment between `c` and `d` (with `s1` next to `c`) shortens the route:
+ *      -           Move the segment and push `p`, `n`, `c`, `d`, `s1` and `s2` into the queue
+ *      - Until the queue is empty
+ *
+ * @note every move is evaluated in O(1) by or_opt_difference() in `Distance.cpp`, and applied by move_segment().
+ */
+int or_opt(const Instance& cities, const CandidateList& candidates, Tour& tour)
+{
+    const int n_points = tour.size();
+    if (n_points < OR_OPT_SEGMENT + 5) { return 0; }        /// The segment, its neighbors and the insertion edge must be distinct
+    std::deque<int> queue;
+    std::vector<char> queued(n_points, 1);
+    for (int i = 0, city = 0; i < n_points; i += 1, city = tour.next(city))
+    {
+        queue.push_back(city);
+    }
+    auto push = [&](const int city)
+    {
+        if (!queued[city]) { queued[city] = 1; queue.push_back(city); }
+    };
+
+    int moves = 0;
+    std::array<int, OR_OPT_SEGMENT> segment;                /// Declare an array to store the cities of the segment
+    while (!queue.empty())
+    {
+        const int s1 = queue.front();
+        queue.pop_front();
+        queued[s1] = 0;
+        bool improved = false;
+        for (int length = 1; length <= OR_OPT_SEGMENT && !improved; length += 1)
+        {
+            for (int side = 0; side < (length == 1 ? 1 : 2) && !improved; side += 1)
+            {                                               /// Grow the segment towards the successors first and the predecessors second
+                segment[0] = s1;
+                for (int l = 1; l < length; l += 1)
+                {
+                    segment[l] = (side == 0 ? tour.next(segment[l - 1]) : tour.prev(segment[l - 1]));
+                }
+                const int s2 = segment[length - 1];
+                const int p = (side == 0 ? tour.prev(s1) : tour.next(s1));
+                const int n = (side == 0 ? tour.next(s2) : tour.prev(s2));
+                auto excluded = [&](const int city)
+                {
+                    return city == p || city == n || std::find(segment.begin(), segment.begin() + length, city) != segment.begin() + length;
+                };
+                const double removal_gain = (double)(tsp_hop_cost(cities, p, s1).second + tsp_hop_cost(cities, s2, n).second - tsp_hop_cost(cities, p, n).second);
+                const int* neighbors = candidates.neighbors_of(s1);
+                const double* distances = candidates.distances_of(s1);
+                for (int j = 0; j < candidates.k && !improved; j += 1)
+                {
+                    const int c = neighbors[j];
+                    if (distances[j] >= removal_gain) { break; }
+                                                            /// No further candidate can yield a positive gain
+                    if (excluded(c)) { continue; }
+                    for (int other = 0; other < 2; other += 1)
+                    {
+                        const int d = (other == 0 ? tour.next(c) : tour.prev(c));
+                        if (excluded(d)) { continue; }
+                        if (or_opt_difference(cities, p, s1, s2, n, c, d) < -1e-9)
+                        {                                   /// Apply the improving move
+                            move_segment(tour, p, s1, s2, n, c, d);
+                            push(p);
+                            push(n);
+                            push(c);
+                            push(d);
+                            push(s1);
+                            push(s2);
+                            moves += 1;
+                            improved = true;
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return moves;
+}
+
+/**
+ * Applies the selected local searches until none of them improves the route.
+ *
+ * @param[in] cities the dataset
+ * @param[in] candidates the candidate lists of `cities` (see `Candidates.h`)
+ * @param[in] local_search the local search flags (see `LOCAL_SEARCH_*` in Common.h)
+ * @param[in, out] tour the TSP route to be improved (see `Tour.h`)
+ *
+ * @return the number of improving moves applied
+ *
+ * @note a move of one kind may create improving moves of the other kind, so the combined
+ *      local search alternates between them until one of them finds no improving move.
+ */
+int local_optimum(const Instance& cities, const CandidateList& candidates, const int local_search, Tour& tour)
+{
+    int moves = 0;
+    if (local_search & LOCAL_SEARCH_2OPT) { moves += two_opt(cities, candidates, tour); }
+    if (local_search & LOCAL_SEARCH_OROPT)
+    {
+        int or_moves = or_opt(cities, candidates, tour);
+        moves += or_moves;
+        while (or_moves > 0 && (local_search & LOCAL_SEARCH_2OPT))
+        {                                                   /// Alternate between the moves until neither of them improves the route
+            const int two_moves = two_opt(cities, candidates, tour);
+            or_moves = (two_moves > 0 ? or_opt(cities, candidates, tour) : 0);
+            moves += two_moves + or_moves;
+        }
+    }
+    return moves;
+}
+
+/**
+ * Finds the best 2-opt move that involves the candidate edges of a city.
+ *
+ * @param[in] cities the dataset
+ * @param[in] candidates the candidate lists of `cities` (see `Candidates.h`)
+ * @param[in] tour the TSP route (see `Tour.h`), which is only read
+ * @param[in] a the city whose neighborhood is searched
+ * @param[out] move the best improving move, if any
+ *
+ * @return true if an improving move was found
+ *
+ * @note the neighborhood is the neighborhood of `two_opt()`, but every candidate is evaluated
+ *      instead of stopping at the first improving move (best improvement).
+ */
+bool best_two_opt_move(const Instance& cities, const CandidateList& candidates, const Tour& tour, const int a, LocalMove& move)
+{
+    move.delta = -1e-9;
+    for (int side = 0; side < 2; side += 1)
+    {
+        const int b = (side == 0 ? tour.next(a) : tour.prev(a));
+        const double d_ab = (double)tsp_hop_cost(cities, a, b).second;
+        const int* neighbors = candidates.neighbors_of(a);
+        const double* distances = candidates.distances_of(a);
+        for (int j = 0; j < candidates.k; j += 1)
+        {
+            const int c = neighbors[j];
+            const double d_ac = distances[j];
+            if (d_ac >= d_ab) { break; }                    /// No further candidate can yield a positive gain
+            const int d = (side == 0 ? tour.next(c) : tour.prev(c));
+            if (c == b || d == a) { continue; }
+            const double delta = d_ac + (double)tsp_hop_cost(cities, b, d).second - d_ab - (double)tsp_hop_cost(cities, c, d).second;
+            if (delta < move.delta)
+            {
+                move.delta = delta;
+                move.size = 4;
+                move.cities = { a, b, c, d };
+            }
+        }
+    }
+    return move.delta < -1e-9;
+}
+
+/**
+ * Finds the best Or-opt move of the segments that start at a city.
+ *
+ * @param[in] cities the dataset
+ * @param[in] candidates the candidate lists of `cities` (see `Candidates.h`)
+ * @param[in] tour the TSP route (see `Tour.h`), which is only read
+ * @param[in] s1 the city where the segments start
+ * @param[out] move the best improving move, if any
+ *
+ * @return true if an improving move was found
+ *
+ * @note the neighborhood is the neighborhood of `or_opt()`, but every segment and every candidate
+ *      is evaluated instead of stopping at the first improving move (best improvement).
+ */
+bool best_or_opt_move(const Instance& cities, const CandidateList& candidates, const Tour& tour, const int s1, LocalMove& move)
+{
+    move.delta = -1e-9;
+    std::array<int, OR_OPT_SEGMENT> segment;
+    for (int length = 1; length <= OR_OPT_SEGMENT; length += 1)
+    {
+        for (int side = 0; side < (length == 1 ? 1 : 2); side += 1)
+        {
+            segment[0] = s1;
+            for (int l = 1; l < length; l += 1)
+            {
+                segment[l] = (side == 0 ? tour.next(segment[l - 1]) : tour.prev(segment[l - 1]));
+            }
+            const int s2 = segment[length - 1];
+            const int p = (side == 0 ? tour.prev(s1) : tour.next(s1));
+            const int n = (side == 0 ? tour.next(s2) : tour.prev(s2));
+            auto excluded = [&](const int city)
+            {
+                return city == p || city == n || std::find(segment.begin(), segment.begin() + length, city) != segment.begin() + length;
+            };
+            const double removal_gain = (double)(tsp_hop_cost(cities, p, s1).second + tsp_hop_cost(cities, s2, n).second - tsp_hop_cost(cities, p, n).second);
+            const int* neighbors = candidates.neighbors_of(s1);
+            const double* distances = candidates.distances_of(s1);
+            for (int j = 0; j < candidates.k; j += 1)
+            {
+                const int c = neighbors[j];
+                if (distances[j] >= removal_gain) { break; }
+                if (excluded(c)) { continue; }
+                for (int other = 0; other < 2; other += 1)
+                {
+                    const int d = (other == 0 ? tour.next(c) : tour.prev(c));
+                    if (excluded(d)) { continue; }
+                    const double delta = (double)or_opt_difference(cities, p, s1, s2, n, c, d);
+                    if (delta < move.delta)
+                    {
+                        move.delta = delta;
+                        move.size = 6 + std::max(0, length - 2);
+                        move.cities = { s1, s2, p, n, c, d };
+                        for (int l = 1; l < length - 1; l += 1) { move.cities[5 + l] = segment[l]; }
+                    }                                       /// The inner cities keep their edges, but the segment must still be in place when the move is applied
+                }
+            }
+        }
+    }
+    return move.delta < -1e-9;
+}
+
+/**
+ * Improves a TSP route with batches of non-overlapping improving moves, which are evaluated in parallel.
+ *
+ * @param[in] cities the dataset
+ * @param[in] candidates the candidate lists of `cities` (see `Candidates.h`)
+ * @param[in] local_search the moves to evaluate (see `LOCAL_SEARCH_*` in Common.h)
+ * @param[in, out] tour the TSP route to be improved (see `Tour.h`)
+ * @param[in] n_threads the number of threads that evaluate the moves
+ *
+ * @return the number of improving moves applied
+ *
+ * @remark Parallel local search with don't look bits:
+ *      - Push all the cities into a queue, in route order
+ *      - Repeat:
+ *      -   Split the queue among the threads, and find the best move of every city concurrently
+ *      -   Sort the moves from the best to the worst
+ *      -   For each move:
+ *      -     If none of its cities was touched by a move of this batch, apply it and push its cities
+ *      -     Else push the city it was found for, so that its move is evaluated again
+ *      -   The cities without an improving move set their don't look bits
+ *      - Until the queue is empty
+ *
+ * @note every thread collects the moves of its own part of the queue, so the evaluation needs
+ *      no synchronization, and the moves are sorted by their gain and then by their city, so the
+ *      route does not depend on the number of threads. A move only removes edges between its own
+ *      cities, so a move whose cities were not touched finds its edges in place. Still, a flip may
+ *      reverse the path between the edges of a 2-opt move, and then `b` and `d` no longer lie on
+ *      the same side of `a` and `c`, so such a move is evaluated again. An Or-opt move is valid in
+ *      either direction of the route. The moves are applied by the master thread, since every flip
+ *      may reverse a large part of the route. When both kinds of moves are selected, every city
+ *      offers the better of its 2 moves, so the search does not alternate between them.
+ */
+int parallel_moves(const Instance& cities, const CandidateList& candidates, const int local_search, Tour& tour, const int n_threads)
+{
+    const int n_points = tour.size();
+    const bool use_two_opt = (local_search & LOCAL_SEARCH_2OPT) && n_points >= 5;
+    const bool use_or_opt = (local_search & LOCAL_SEARCH_OROPT) && n_points >= OR_OPT_SEGMENT + 5;
+    if (!use_two_opt && !use_or_opt) { return 0; }
+    std::vector<int> queue;                                 /// Declare the queue of the cities that are to be examined in the next round
+    queue.reserve(n_points);
+    for (int i = 0, city = 0; i < n_points; i += 1, city = tour.next(city))
+    {
+        queue.push_back(city);                              /// Consecutive cities of the queue lie in the same region of the route
+    }
+    std::vector<char> queued(n_points, 1);
+    std::vector<int> touched(n_points, -1);                 /// Declare a vector to store the last batch that changed the edges of each city
+    std::vector<int> round_cities;
+    std::vector<std::vector<LocalMove>> found(n_threads);   /// Declare a vector of moves for each thread
+    std::vector<LocalMove> batch;
+    auto push = [&](const int city)
+    {
+        if (!queued[city]) { queued[city] = 1; queue.push_back(city); }
+    };
+
+    int moves = 0;
+    for (int round = 0; !queue.empty(); round += 1)
+    {
+        round_cities.swap(queue);
+        queue.clear();
+        for (const int city : round_cities) { queued[city] = 0; }
+        for (std::vector<LocalMove>& moves_found : found) { moves_found.clear(); }
+        const int n_cities = (int)round_cities.size();
+#pragma omp parallel num_threads(n_threads)
+        {
+            std::vector<LocalMove>& moves_found = found[omp_get_thread_num()];
+            LocalMove move, or_move;
+#pragma omp for schedule(static)
+            for (int i = 0; i < n_cities; i += 1)
+            {
+                const bool two_opt_found = use_two_opt && best_two_opt_move(cities, candidates, tour, round_cities[i], move);
+                if (use_or_opt && best_or_opt_move(cities, candidates, tour, round_cities[i], or_move) && (!two_opt_found || or_move.delta < move.delta))
+                {
+                    moves_found.push_back(or_move);
+                }
+                else if (two_opt_found) { moves_found.push_back(move); }
+            }
+        }
+        batch.clear();
+        for (const std::vector<LocalMove>& moves_found : found) { batch.insert(batch.end(), moves_found.begin(), moves_found.end()); }
+        std::sort(batch.begin(), batch.end(), [](const LocalMove& one, const LocalMove& two)
+        {
+            return (one.delta != two.delta ? one.delta < two.delta : one.cities[0] < two.cities[0]);
+        });
+        for (const LocalMove& move : batch)
+        {
+            const int* c = move.cities.data();
+            const bool conflict = std::any_of(c, c + move.size, [&](const int city) { return touched[city] == round; });
+            const bool two_opt_move = (move.size == 4);
+            if (conflict || (two_opt_move && (tour.next(c[0]) == c[1] ? tour.next(c[2]) != c[3] : tour.prev(c[2]) != c[3])))
+            {
+                push(c[0]);                                 /// The route around the city changed, so its best move is evaluated again
+                continue;
+            }
+            if (two_opt_move) { tour.flip(c[0], c[1], c[2], c[3]); }
+            else { move_segment(tour, c[2], c[0], c[1], c[3], c[4], c[5]); }
+            for (int i = 0; i < move.size; i += 1)
+            {
+                touched[c[i]] = round;
+                push(c[i]);
+            }
+            moves += 1;
+        }
+    }
+    return moves;
+}
+
+/**
+ * Improves a TSP route with 2-opt moves until it is 2-optimal with respect to the candidate lists. This is a
+ * fork of the `two_opt` function above, which evaluates the moves in parallel and applies them in batches.
+ *
+ * @param[in] cities the dataset
+ * @param[in] candidates the candidate lists of `cities` (see `Candidates.h`)
+ * @param[in, out] tour the TSP route to be improved (see `Tour.h`)
+ * @param[in] n_threads the number of threads that evaluate the moves
+ *
+ * @return the number of improving moves applied
+ */
+int two_opt_parallel(const Instance& cities, const CandidateList& candidates, Tour& tour, const int n_threads)
+{
+    return parallel_moves(cities, candidates, LOCAL_SEARCH_2OPT, tour, n_threads);
+}
+
+/**
+ * Improves a TSP route with Or-opt moves until it is Or-optimal with respect to the candidate lists. This is a
+ * fork of the `or_opt` function above, which evaluates the moves in parallel and applies them in batches.
+ *
+ * @param[in] cities the dataset
+ * @param[in] candidates the candidate lists of `cities` (see `Candidates.h`)
+ * @param[in, out] tour the TSP route to be improved (see `Tour.h`)
+ * @param[in] n_threads the number of threads that evaluate the moves
+ *
+ * @return the number of improving moves applied
+ */
+int or_opt_parallel(const Instance& cities, const CandidateList& candidates, Tour& tour, const int n_threads)
+{
+    return parallel_moves(cities, candidates, LOCAL_SEARCH_OROPT, tour, n_threads);
+}
+
+/**
+ * Applies the selected local searches until none of them improves the route. This is a fork of the
+ * `local_optimum` function above, with the parallel engine.
+ *
+ * @param[in] cities the dataset
+ * @param[in] candidates the candidate lists of `cities` (see `Candidates.h`)
+ * @param[in] local_search the local search flags (see `LOCAL_SEARCH_*` in Common.h)
+ * @param[in, out] tour the TSP route to be improved (see `Tour.h`)
+ * @param[in] n_threads the number of threads that evaluate the moves
+ *
+ * @return the number of improving moves applied
+ *
+ * @note the 2 kinds of moves are evaluated together, so a single pass reaches a route that is both
+ *      2-optimal and Or-optimal.
+ */
+int local_optimum_parallel(const Instance& cities, const CandidateList& candidates, const int local_search, Tour& tour, const int n_threads)
+{
+    return parallel_moves(cities, candidates, local_search, tour, n_threads);
+}
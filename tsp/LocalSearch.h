@@ -0,0 +1,52 @@
+/**
+ * LocalSearch.h
+ *
+ * In this header file, we define the local search engines
+ * that improve a TSP route produced by any of the approaches
+ * of the project, with 2-opt moves (reversing a path) and
+ * Or-opt moves (moving a segment of up to `OR_OPT_SEGMENT`
+ * cities elsewhere in the route). Instead of trying random moves for a fixed
+ * number of iterations, the engines only consider the moves
+ * that involve the candidate neighbors of a city (see
+ * `Candidates.h`), and keep a queue of the cities whose
+ * neighborhood changed. A city whose moves were all tried
+ * without success has its "don't look bit" set, and is not
+ * considered again until one of its tour neighbors changes.
+ * The search terminates at a local optimum, where the queue
+ * is empty. The parallel engines work in rounds instead:
+ * the best move of every city in the queue is evaluated
+ * concurrently, and the moves that do not share a city are
+ * applied in a batch, from the best to the worst.
+ *
+ * @remark https://www.sciencedirect.com/science/article/pii/0377221792900138
+ * @remark https://www.jstor.org/stable/169577
+ * @remark https://www.cs.ubc.ca/~hutter/previous-earg/EmpAlgReadingGroup/TSP-JohMcg97.pdf
+ */
+
+#pragma once
+
+#include "Common.h"
+#include "Distance.h"
+#include "Instance.h"
+#include "Candidates.h"
+#include "Tour.h"
+
+/**
+ * An improving move found by the parallel local search, which changes the edges of its cities only.
+ *
+ * @note the first city is the city whose neighborhood was searched. A move whose cities were not
+ *      touched by the moves applied before it in the same batch still finds all its edges in place.
+ */
+struct LocalMove
+{
+    double delta;                                           /// The change of the route cost, which is negative
+    int size;                                               /// The number of cities in `cities`
+    std::array<int, OR_OPT_SEGMENT + 4> cities;             /// `a`, `b`, `c` and `d` of a 2-opt move, or `s1`, `s2`, `p`, `n`, `c`, `d` and the inner cities of the segment of an Or-opt move
+};
+
+int two_opt(const Instance& cities, const CandidateList& candidates, Tour& tour);
+int or_opt(const Instance& cities, const CandidateList& candidates, Tour& tour);
+int local_optimum(const Instance& cities, const CandidateList& candidates, const int local_search, Tour& tour);
+int two_opt_parallel(const Instance& cities, const CandidateList& candidates, Tour& tour, const int n_threads);
+int or_opt_parallel(const Instance& cities, const CandidateList& candidates, Tour& tour, const int n_threads);
+int local_optimum_parallel(const Instance& cities, const CandidateList& candidates, const int local_search, Tour& tour, const int n_threads);
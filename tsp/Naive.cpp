@@ -15,11 +15,14 @@
 int roulette_wheel(std::vector<std::pair<int, double>>& evaluation, double roulette_random)
 {
     std::sort(evaluation.begin(), evaluation.end(), sortbysec_dbl);             /// Sorts all precomputed evaluations
-    evaluation.erase(evaluation.begin(), evaluation.end() - ROULETTE_SIZE);     /// Reduces the ammount of the evaluations 
+    if (evaluation.size() > ROULETTE_SIZE)                                      /// Near the end of a tour there may be less than `ROULETTE_SIZE` evaluations left
+    {
+        evaluation.erase(evaluation.begin(), evaluation.end() - ROULETTE_SIZE); /// Reduces the ammount of the evaluations 
                                                                                 /// deleting the less likely to be chosen.
                                                                                 /// This masks computationsal error when the
                                                                                 /// dataset is too large. It also makes the 
                                                                                 /// algorithm's convergence faster.
+    }
     double accumulator = 0.0;                                                   /// A variable used to accumulate the different edge evaluations for the roulette wheel
     for (int m = 0; m < evaluation.size(); m += 1)                              /// Reformat all evaluations to feed the roulette wheel selection algorithm
     {
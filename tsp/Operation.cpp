@@ -11,9 +11,9 @@
  * 
  * @note there is a redundancy to trace the "Element Not Found" fault.
  */
-int find(const std::array<int, N_POINTS> non_explored, const int element)
+int find(const std::vector<int>& non_explored, const int element)
 {
-    std::array<int, N_POINTS>::const_iterator it = std::find(non_explored.begin(), non_explored.end(), element);
+    std::vector<int>::const_iterator it = std::find(non_explored.begin(), non_explored.end(), element);
     if (it == non_explored.end())
     {
         std::cout << "[WARNING]: Element not found" << std::endl;
@@ -67,7 +67,7 @@ bool sortbysec_int(const std::pair<int, int>& a, const std::pair<int, int>& b)
  * 
  * @remark Naive.h
  */
-int search(const std::vector<std::pair<int, double>> container, double value)
+int search(const std::vector<std::pair<int, double>>& container, double value)
 {
     std::vector<std::pair<int, double>>::const_iterator it = std::lower_bound(container.begin(), container.end(), value, compare_dbl());
     return container.at((it - container.begin())).first;
@@ -108,10 +108,10 @@ void normalize(std::vector<std::pair<int, double>>& evaluation)
  * @param[in] col_idx the index corresponding column from `pherormone_matrix` to be copied
  * @param[in, out] pherormone_column the vector in which data will be copied
  */
-void copy(const std::vector<std::array<double, N_POINTS>> pherormone_matrix, const int col_idx, std::vector<double>& pherormone_column)
+void copy(const std::vector<std::vector<double>> pherormone_matrix, const int col_idx, std::vector<double>& pherormone_column)
 {
-    pherormone_column.reserve(N_POINTS);
-    for (int j = 0; j < N_POINTS; j += 1)
+    pherormone_column.reserve(pherormone_matrix.size());
+    for (int j = 0; j < (int)pherormone_matrix.size(); j += 1)
     {
         pherormone_column.emplace_back(pherormone_matrix.at(j).at(col_idx));
     }
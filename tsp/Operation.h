@@ -47,12 +47,12 @@ struct compare_dbl
     bool operator()(const double& key, const std::pair<int, double>& value) { return (key < value.second); }
 };
 
-int find(const std::array<int, N_POINTS> non_explored, const int element);
+int find(const std::vector<int>& non_explored, const int element);
 bool sortbysec_dbl(const std::pair<int, double>& a, const std::pair<int, double>& b);
 bool sortbysec_int(const std::pair<int, int>& a, const std::pair<int, int>& b);
-int search(const std::vector<std::pair<int, double>> container, double value);
+int search(const std::vector<std::pair<int, double>>& container, double value);
 std::pair<int, double> normalized_value(std::pair<int, double> p, double min, double max);
 void normalize(std::vector<std::pair<int, double>>& evaluation);
-void copy(const std::vector<std::array<double, N_POINTS>> pherormone_matrix, const int col_idx, std::vector<double>& pherormone_column);
+void copy(const std::vector<std::vector<double>> pherormone_matrix, const int col_idx, std::vector<double>& pherormone_column);
 void filter(std::vector<std::pair<int, double>>& roulette, const std::vector<int> tsp_route);
 std::pair<int, double> f(int i, double d);
@@ -1,18 +1,474 @@
 
 #include "Pherormone.h"
+#include "Kernel.h"
+
+#if defined(_WIN32)
+#include <malloc.h>                                         /// _aligned_malloc
+#else
+#include <sys/mman.h>                                       /// mmap, madvise
+#endif
+
+constexpr size_t HUGE_PAGE_SIZE = 2 << 20;                  /// The size of a huge page in bytes, to which huge page backed allocations are rounded
 
 /**
  * Initializes a matrix.
- * 
+ *
  * @param[in, out] pherormone_matrix the matrix given for initialization
- * 
+ * @param[in] n_points the number of cities (the matrix is resized to `n_points` x `n_points`)
+ *
  * @note this is used to initialize the pherormone matrix
  */
-void initialize_pherormone_matrix(std::vector<std::array<double, N_POINTS>>& pherormone_matrix)
+void initialize_pherormone_matrix(std::vector<std::vector<double>>& pherormone_matrix, const int n_points)
 {
-    for (int i = 0; i < N_POINTS; i += 1)
+    pherormone_matrix.assign(n_points, std::vector<double>(n_points, 1.0));
+                                                /// Fill every row of the matrix with ones. That way all nodes have an equal chance to be selected by any ant.
+    for (int i = 0; i < n_points; i += 1)
     {
-        pherormone_matrix.at(i).fill(1.0);      /// Fill the `i`-th row of the matrix with ones. That way all nodes have an equal chance to be selected by any ant.
         pherormone_matrix.at(i).at(i) = 0.0;    /// Change the diagonal element to zero. That way we reinforce the ants not to chose the same node.
     }
 }
+
+/**
+ * Resolves the pherormone store of the ACS.
+ *
+ * @param[in] settings the run time settings (pherormone store)
+ * @param[in] n_points the number of cities
+ *
+ * @return `PHERORMONE_DENSE`, `PHERORMONE_SPARSE` or `PHERORMONE_COMPACT`
+ */
+int pherormone_store(const Settings& settings, const int n_points)
+{
+    if (settings.pherormone != PHERORMONE_AUTO) { return settings.pherormone; }
+    return (n_points <= DENSE_PHERORMONE_LIMIT ? PHERORMONE_DENSE : PHERORMONE_SPARSE);
+}
+
+/**
+ * Allocates the dense pherormone store.
+ *
+ * @param[in] candidates the candidate lists of the cities (see `Candidates.h`)
+ * @param[in] n_points the number of cities
+ */
+DensePherormone::DensePherormone(const CandidateList& candidates, const int n_points) : candidates(candidates)
+{
+    initialize_pherormone_matrix(pherormone_matrix, n_points);
+}
+
+/**
+ * Adds pherormone to an edge atomically, so that concurrent deposits need no lock.
+ *
+ * @param[in] a the city where the edge starts
+ * @param[in] b the city where the edge ends
+ * @param[in] amount the pherormone deposited
+ */
+void DensePherormone::deposit_atomic(const int a, const int b, const double amount)
+{
+    const double scaled = amount / scale;
+    double& value = pherormone_matrix[a][b];
+#pragma omp atomic
+    value += scaled;
+}
+
+/**
+ * Vaporizes the pherormone of every edge, which costs O(1) unless the matrix has to be normalized.
+ */
+void DensePherormone::evaporate()
+{
+    scale = (1 - RHO) * scale;                              /// Vaporizes pherormone in each edge
+    if (scale < EVAPORATION_FLOOR) { normalize(false); }
+}
+
+/**
+ * Vaporizes the pherormone of every edge. This is a fork of the `evaporate` function above, which normalizes the matrix in parallel.
+ */
+void DensePherormone::evaporate_parallel()
+{
+    scale = (1 - RHO) * scale;
+    if (scale < EVAPORATION_FLOOR) { normalize(true); }
+}
+
+/**
+ * Applies the pending evaporation to every edge, so that the matrix holds the pherormone itself.
+ *
+ * @param[in] parallel if true, the rows are normalized in parallel
+ */
+void DensePherormone::normalize(const bool parallel)
+{
+    const int n_points = (int)pherormone_matrix.size();
+    const double factor = scale;
+#pragma omp parallel for schedule(static) if(parallel)
+    for (int j = 0; j < n_points; j += 1)
+    {
+        for (int k = 0; k < n_points; k += 1)
+        {
+            pherormone_matrix[j][k] = factor * pherormone_matrix[j][k];
+        }
+    }
+    scale = 1.0;
+}
+
+/**
+ * Sets the pherormone of every edge, except for the diagonal, which stays zero.
+ *
+ * @param[in] value the pherormone of every edge
+ */
+void DensePherormone::fill(const double value)
+{
+    const int n_points = (int)pherormone_matrix.size();
+    scale = 1.0;
+    for (int j = 0; j < n_points; j += 1)
+    {
+        std::fill(pherormone_matrix[j].begin(), pherormone_matrix[j].end(), value);
+        pherormone_matrix[j][j] = 0.0;
+    }
+}
+
+/**
+ * Bounds the pherormone of every edge, which costs O(1): the bounds are applied whenever an edge is read or deposited.
+ *
+ * @param[in] lower the lower bound of the pherormone
+ * @param[in] upper the upper bound of the pherormone
+ *
+ * @note a deposit first applies the bounds to the edge, as a sweep over every edge would have, and then adds
+ *      its pherormone, which the bounds cap again when it is read. The atomic deposits only add their pherormone.
+ */
+void DensePherormone::clamp(const double lower, const double upper)
+{
+    lower_bound = lower;
+    upper_bound = upper;
+}
+
+/**
+ * Allocates the sparse pherormone store.
+ *
+ * @param[in] candidates the candidate lists of the cities (see `Candidates.h`)
+ * @param[in] n_points the number of cities
+ *
+ * @note as in the dense store, every edge starts with a pherormone of 1. A city is never
+ *      a candidate of itself, so the diagonal is implicitly excluded.
+ */
+SparsePherormone::SparsePherormone(const CandidateList& candidates, const int n_points)
+    : candidates(candidates), values((size_t)n_points * candidates.k, 1.0), default_value(1.0)
+{
+}
+
+/**
+ * Finds the position of an edge inside the candidates of its first city.
+ *
+ * @param[in] a the city where the edge starts
+ * @param[in] b the city where the edge ends
+ *
+ * @return the position of `b` inside the candidates of `a`, or -1 if the edge is not a candidate edge
+ *
+ * @note the edge is looked up in the candidates of `a`, which costs O(k).
+ */
+int SparsePherormone::slot_of(const int a, const int b) const
+{
+    const int* neighbors = candidates.neighbors_of(a);
+    for (int slot = 0; slot < candidates.k; slot += 1)
+    {
+        if (neighbors[slot] == b) { return slot; }
+    }
+    return -1;
+}
+
+/**
+ * Fetches the pherormone of any edge.
+ *
+ * @param[in] a the city where the edge starts
+ * @param[in] b the city where the edge ends
+ *
+ * @return the pherormone of the edge, or the default value if the edge is not a candidate edge of `a`
+ */
+double SparsePherormone::edge(const int a, const int b) const
+{
+    const int slot = slot_of(a, b);
+    return bounded(scale * (slot >= 0 ? values[(size_t)a * candidates.k + slot] : default_value));
+}
+
+/**
+ * Adds pherormone to an edge.
+ *
+ * @param[in] a the city where the edge starts
+ * @param[in] b the city where the edge ends
+ * @param[in] amount the pherormone deposited
+ */
+void SparsePherormone::deposit(const int a, const int b, const double amount)
+{
+    const int slot = slot_of(a, b);
+    if (slot < 0) { return; }
+    double& value = values[(size_t)a * candidates.k + slot];
+    value = (bounded(scale * value) + amount) / scale;
+}
+
+/**
+ * Adds pherormone to an edge atomically, so that concurrent deposits need no lock.
+ *
+ * @param[in] a the city where the edge starts
+ * @param[in] b the city where the edge ends
+ * @param[in] amount the pherormone deposited
+ */
+void SparsePherormone::deposit_atomic(const int a, const int b, const double amount)
+{
+    const int slot = slot_of(a, b);
+    if (slot < 0) { return; }
+    const double scaled = amount / scale;
+    double& value = values[(size_t)a * candidates.k + slot];
+#pragma omp atomic
+    value += scaled;
+}
+
+/**
+ * Vaporizes the pherormone of every edge, which costs O(1) unless the values have to be normalized.
+ */
+void SparsePherormone::evaporate()
+{
+    scale = (1 - RHO) * scale;
+    if (scale < EVAPORATION_FLOOR) { normalize(false); }
+}
+
+/**
+ * Vaporizes the pherormone of every edge. This is a fork of the `evaporate` function above, which normalizes the values in parallel.
+ */
+void SparsePherormone::evaporate_parallel()
+{
+    scale = (1 - RHO) * scale;
+    if (scale < EVAPORATION_FLOOR) { normalize(true); }
+}
+
+/**
+ * Applies the pending evaporation to every edge, so that the values hold the pherormone itself.
+ *
+ * @param[in] parallel if true, the values are normalized in parallel
+ */
+void SparsePherormone::normalize(const bool parallel)
+{
+    const long long n_values = (long long)values.size();
+    const double factor = scale;
+#pragma omp parallel for schedule(static) if(parallel)
+    for (long long i = 0; i < n_values; i += 1)
+    {
+        values[i] = factor * values[i];
+    }
+    default_value = factor * default_value;
+    scale = 1.0;
+}
+
+/**
+ * Sets the pherormone of every edge.
+ *
+ * @param[in] value the pherormone of every edge
+ */
+void SparsePherormone::fill(const double value)
+{
+    scale = 1.0;
+    std::fill(values.begin(), values.end(), value);
+    default_value = value;
+}
+
+/**
+ * Bounds the pherormone of every edge in O(1), like `DensePherormone::clamp()`.
+ *
+ * @param[in] lower the lower bound of the pherormone
+ * @param[in] upper the upper bound of the pherormone
+ */
+void SparsePherormone::clamp(const double lower, const double upper)
+{
+    lower_bound = lower;
+    upper_bound = upper;
+}
+
+/**
+ * Allocates the compact pherormone store.
+ *
+ * @param[in] candidates the candidate lists of the cities (see `Candidates.h`)
+ * @param[in] n_points the number of cities
+ * @param[in] huge_pages if true, the kernel is asked to back the store with huge pages
+ *
+ * @note the store is allocated with an anonymous mapping, which is page aligned. With huge pages,
+ *      the evaporation sweep and the random accesses of the ants miss the TLB far less often.
+ *      On Windows, huge pages require a privilege, so the store is an aligned allocation instead.
+ */
+CompactPherormone::CompactPherormone(const CandidateList& candidates, const int n_points, const bool huge_pages)
+    : candidates(candidates), row(n_points)
+{
+    constexpr size_t row_alignment = PHERORMONE_ALIGNMENT / sizeof(float);
+                                                            /// The number of values of a cache line
+    for (int i = 0; i < n_points; i += 1)
+    {
+        row[i] = n_values;
+        n_values += ((size_t)i + row_alignment) / row_alignment * row_alignment;
+                                                            /// The row holds `i` + 1 values, padded to a multiple of a cache line
+    }
+    n_bytes = std::max<size_t>(n_values * sizeof(float), PHERORMONE_ALIGNMENT);
+#if defined(_WIN32)
+    values = static_cast<float*>(_aligned_malloc(n_bytes, PHERORMONE_ALIGNMENT));
+    if (values == nullptr) { throw std::bad_alloc(); }
+#else
+    if (huge_pages) { n_bytes = (n_bytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE; }
+    void* address = mmap(nullptr, n_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (address == MAP_FAILED) { throw std::bad_alloc(); }
+#if defined(MADV_HUGEPAGE)
+    if (huge_pages) { madvise(address, n_bytes, MADV_HUGEPAGE); }
+                                                            /// The advice must be given before the pages are touched
+#endif
+    values = static_cast<float*>(address);
+#endif
+    fill(1.0);                                              /// As in the dense store, every edge starts with a pherormone of 1
+}
+
+/**
+ * Releases the compact pherormone store.
+ */
+CompactPherormone::~CompactPherormone()
+{
+#if defined(_WIN32)
+    _aligned_free(values);
+#else
+    munmap(values, n_bytes);
+#endif
+}
+
+/**
+ * Sets the pherormone of every edge, except for the diagonal and the padding, which stay zero.
+ *
+ * @param[in] value the pherormone of every edge
+ */
+void CompactPherormone::fill(const double value)
+{
+    const int n_points = (int)row.size();
+    scale = 1.0;
+    for (int i = 0; i < n_points; i += 1)
+    {
+        std::fill(values + row[i], values + row[i] + i, (float)value);
+        std::fill(values + row[i] + i, values + (i + 1 < n_points ? row[i + 1] : n_values), 0.0f);
+                                                            /// The diagonal and the padding of the row are zero
+    }
+}
+
+/**
+ * Bounds the pherormone of every edge in O(1), like `DensePherormone::clamp()`.
+ *
+ * @param[in] lower the lower bound of the pherormone
+ * @param[in] upper the upper bound of the pherormone
+ */
+void CompactPherormone::clamp(const double lower, const double upper)
+{
+    lower_bound = lower;
+    upper_bound = upper;
+}
+
+/**
+ * Adds pherormone to an edge atomically, so that concurrent deposits need no lock.
+ *
+ * @param[in] a the first city of the edge
+ * @param[in] b the second city of the edge
+ * @param[in] amount the pherormone deposited
+ */
+void CompactPherormone::deposit_atomic(const int a, const int b, const double amount)
+{
+    const float scaled = (float)(amount / scale);
+    float& value = values[index(a, b)];
+#pragma omp atomic
+    value += scaled;
+}
+
+/**
+ * Vaporizes the pherormone of every edge, which costs O(1) unless the buffer has to be normalized.
+ */
+void CompactPherormone::evaporate()
+{
+    scale = (1 - RHO) * scale;
+    if (scale < EVAPORATION_FLOOR) { normalize(false); }
+}
+
+/**
+ * Vaporizes the pherormone of every edge. This is a fork of the `evaporate` function above, which normalizes the buffer in parallel.
+ */
+void CompactPherormone::evaporate_parallel()
+{
+    scale = (1 - RHO) * scale;
+    if (scale < EVAPORATION_FLOOR) { normalize(true); }
+}
+
+/**
+ * Applies the pending evaporation to every edge, so that the buffer holds the pherormone itself. The buffer is swept once.
+ *
+ * @param[in] parallel if true, the buffer is normalized in parallel
+ */
+void CompactPherormone::normalize(const bool parallel)
+{
+    const long long n_floats = (long long)n_values;
+    const float factor = (float)scale;
+    float* buffer = values;
+#pragma omp parallel for simd schedule(static) aligned(buffer : PHERORMONE_ALIGNMENT) if(parallel)
+    for (long long i = 0; i < n_floats; i += 1)
+    {
+        buffer[i] = factor * buffer[i];
+    }
+    scale = 1.0;
+}
+
+/**
+ * Tabulates the heuristic information of the candidate edges.
+ *
+ * @param[in] candidates the candidate lists of the cities (see `Candidates.h`)
+ * @param[in] n_points the number of cities
+ *
+ * @note the lengths of the candidate edges are already kept by the candidate lists, so the
+ *      heuristic information is computed once here and never again. The choice information
+ *      is undefined until the first `refresh()`.
+ */
+ChoiceInfo::ChoiceInfo(const CandidateList& candidates, const int n_points)
+    : candidates(candidates), heuristic((size_t)n_points * candidates.k), choice((size_t)n_points * candidates.k)
+{
+    for (size_t i = 0; i < heuristic.size(); i += 1)
+    {
+        heuristic[i] = power(1 / candidates.distances[i], BETA);
+    }
+}
+
+/**
+ * Recomputes the choice information of every candidate edge from the pherormone store.
+ *
+ * @param[in] pherormone the store with the pherormone ammount left in each edge
+ */
+template <typename Store>
+void ChoiceInfo::refresh(const Store& pherormone)
+{
+    const int n_points = (int)(choice.size() / candidates.k);
+    for (int city = 0; city < n_points; city += 1)
+    {
+        for (int slot = 0; slot < candidates.k; slot += 1)
+        {
+            const size_t i = (size_t)city * candidates.k + slot;
+            choice[i] = power(pherormone.candidate(city, slot), ALPHA) * heuristic[i];
+        }
+    }
+}
+
+/**
+ * Recomputes the choice information of every candidate edge from the pherormone store. This is a fork of the `refresh` function above, parallelized with OpenMP 4.0.
+ *
+ * @param[in] pherormone the store with the pherormone ammount left in each edge
+ */
+template <typename Store>
+void ChoiceInfo::refresh_parallel(const Store& pherormone)
+{
+    const int n_points = (int)(choice.size() / candidates.k);
+#pragma omp parallel for schedule(static)
+    for (int city = 0; city < n_points; city += 1)
+    {
+        for (int slot = 0; slot < candidates.k; slot += 1)
+        {
+            const size_t i = (size_t)city * candidates.k + slot;
+            choice[i] = power(pherormone.candidate(city, slot), ALPHA) * heuristic[i];
+        }
+    }
+}
+
+template void ChoiceInfo::refresh<DensePherormone>(const DensePherormone&);
+template void ChoiceInfo::refresh<SparsePherormone>(const SparsePherormone&);
+template void ChoiceInfo::refresh<CompactPherormone>(const CompactPherormone&);
+template void ChoiceInfo::refresh_parallel<DensePherormone>(const DensePherormone&);
+template void ChoiceInfo::refresh_parallel<SparsePherormone>(const SparsePherormone&);
+template void ChoiceInfo::refresh_parallel<CompactPherormone>(const CompactPherormone&);
@@ -1,15 +1,226 @@
-
 /**
  * Pherormone.h
- * 
- * In this header file, we define a function that
- * executes only in the beginning of the ACS algorithm.
- * This function is used to initialize the pherormone
- * matrix that the ACS will use to colonize a map.
+ *
+ * In this header file, we define the stores that hold
+ * the pherormone of the edges that the ACS colonizes.
+ * The dense store is the original `n_points` x `n_points`
+ * matrix. The sparse store only keeps the pherormone of
+ * the candidate edges (see `Candidates.h`), stored as a
+ * flat `n_points` x `k` array aligned with the candidate
+ * lists, along with a single default value shared by all
+ * the other edges. Since the ants only follow candidate
+ * edges (unless all of them have been explored), the two
+ * stores colonize the map alike, but the sparse store
+ * takes O(n * k) memory instead of O(n^2), so the ACS can
+ * run on instances of hundreds of thousands of cities.
+ * The compact store is a dense store of `float` values
+ * that only keeps the lower triangle of the matrix, since
+ * the edges are symmetric. Its rows are aligned and padded
+ * to cache lines, and it can be backed by huge pages, so
+ * it takes a quarter of the memory of the dense matrix and
+ * its evaporation sweeps a quarter of the bytes. All the
+ * stores expose the same members, so the ACS is written
+ * once as a template over the store. Since the pherormone
+ * only changes between the iterations, the attractiveness
+ * of the candidate edges can also be tabulated once per
+ * iteration (`ChoiceInfo`), so that the ants only load it.
+ * Every store evaporates lazily: instead of multiplying
+ * every value by (1 - RHO), the evaporation multiplies a
+ * single scale factor, which is applied on every read and
+ * divided out of every deposit. The values are multiplied
+ * by the scale factor (`normalize`) only when it drops
+ * below `EVAPORATION_FLOOR`, so that they never overflow.
+ * The bounds of the MAX - MIN Ant System are kept lazily
+ * as well (`clamp`): they are applied whenever an edge is
+ * read or deposited, instead of sweeping every edge.
+ * Thus an iteration only costs what the ants touch.
  */
 
 #pragma once
 
 #include "Common.h"
+#include "Candidates.h"
+
+/**
+ * The pherormone of every edge, stored as a dense matrix.
+ */
+class DensePherormone
+{
+public:
+    DensePherormone(const CandidateList& candidates, const int n_points);
+
+    static constexpr bool symmetric = false;                /// The 2 directions of an edge are kept apart
+    double candidate(const int city, const int slot) const { return bounded(scale * pherormone_matrix[city][candidates.neighbors_of(city)[slot]]); }
+                                                            /// Returns the pherormone of the edge from a city to its `slot`-th candidate
+    double non_candidate(const int a, const int b) const { return bounded(scale * pherormone_matrix[a][b]); }
+                                                            /// Returns the pherormone of an edge that is not a candidate edge of `a`
+    double edge(const int a, const int b) const { return bounded(scale * pherormone_matrix[a][b]); }
+                                                            /// Returns the pherormone of any edge
+    void deposit(const int a, const int b, const double amount) { pherormone_matrix[a][b] = (edge(a, b) + amount) / scale; }
+    void deposit_atomic(const int a, const int b, const double amount);
+    int row_of(const int a, const int) const { return a; }  /// Returns the row of the store where an edge is kept
+    void evaporate();
+    void evaporate_parallel();
+    void fill(const double value);
+    void clamp(const double lower, const double upper);
+    void normalize(const bool parallel);
+    const std::vector<std::vector<double>>& matrix() const { return pherormone_matrix; }
+                                                            /// Returns the matrix, which only holds the pherormone after `normalize()`, before the bounds are applied
+
+private:
+    double bounded(const double value) const { return std::min(upper_bound, std::max(lower_bound, value)); }
+
+    const CandidateList& candidates;                        /// The candidate lists of the cities
+    std::vector<std::vector<double>> pherormone_matrix;     /// The `n_points` x `n_points` pherormone matrix, divided by `scale`
+    double scale = 1.0;                                     /// The evaporation that has not been applied to the matrix yet
+    double lower_bound = 0.0;                               /// The lower bound of the pherormone of an edge, applied when the edge is read or deposited
+    double upper_bound = std::numeric_limits<double>::infinity();
+                                                            /// The upper bound of the pherormone of an edge, applied when the edge is read or deposited
+};
+
+/**
+ * The pherormone of the candidate edges, along with a default value for the other edges.
+ *
+ * @note a deposit on an edge that is not a candidate edge is dropped, and the pherormone of
+ *      such edges only evaporates. Ants only follow those edges when all the candidates of
+ *      their city have been explored, and then they choose among them based on the distance.
+ */
+class SparsePherormone
+{
+public:
+    SparsePherormone(const CandidateList& candidates, const int n_points);
+
+    static constexpr bool symmetric = false;
+    double candidate(const int city, const int slot) const { return bounded(scale * values[(size_t)city * candidates.k + slot]); }
+    double non_candidate(const int, const int) const { return bounded(scale * default_value); }
+    double edge(const int a, const int b) const;
+    void deposit(const int a, const int b, const double amount);
+    void deposit_atomic(const int a, const int b, const double amount);
+    int row_of(const int a, const int) const { return a; }
+    void evaporate();
+    void evaporate_parallel();
+    void fill(const double value);
+    void clamp(const double lower, const double upper);
+    void normalize(const bool parallel);
+
+private:
+    int slot_of(const int a, const int b) const;
+    double bounded(const double value) const { return std::min(upper_bound, std::max(lower_bound, value)); }
+
+    const CandidateList& candidates;                        /// The candidate lists of the cities, which define the stored edges
+    std::vector<double> values;                             /// The `n_points` x `k` pherormone of the candidate edges, aligned with `candidates.neighbors`, divided by `scale`
+    double default_value;                                   /// The pherormone of every edge that is not a candidate edge, divided by `scale`
+    double scale = 1.0;                                     /// The evaporation that has not been applied to the values yet
+    double lower_bound = 0.0;                               /// The lower bound of the pherormone of an edge, applied when the edge is read or deposited
+    double upper_bound = std::numeric_limits<double>::infinity();
+                                                            /// The upper bound of the pherormone of an edge, applied when the edge is read or deposited
+};
+
+/**
+ * The pherormone of every edge, stored as the lower triangle of a symmetric `float` matrix.
+ *
+ * @note a deposit on the edge (a, b) is also a deposit on the edge (b, a), while the dense
+ *      store keeps the 2 directions apart. Every row starts at a `PHERORMONE_ALIGNMENT` byte
+ *      boundary and is padded to a multiple of it, and the padding is evaporated along with
+ *      the rows, so that the evaporation is a single sweep over the whole buffer.
+ */
+class CompactPherormone
+{
+public:
+    CompactPherormone(const CandidateList& candidates, const int n_points, const bool huge_pages);
+    ~CompactPherormone();
+
+    CompactPherormone(const CompactPherormone&) = delete;
+    CompactPherormone& operator=(const CompactPherormone&) = delete;
+
+    static constexpr bool symmetric = true;                 /// The 2 directions of an edge share their pherormone
+    double candidate(const int city, const int slot) const { return bounded(scale * values[index(city, candidates.neighbors_of(city)[slot])]); }
+    double non_candidate(const int a, const int b) const { return bounded(scale * values[index(a, b)]); }
+    double edge(const int a, const int b) const { return bounded(scale * values[index(a, b)]); }
+    void deposit(const int a, const int b, const double amount) { values[index(a, b)] = (float)((edge(a, b) + amount) / scale); }
+    void deposit_atomic(const int a, const int b, const double amount);
+    int row_of(const int a, const int b) const { return std::max(a, b); }
+    void evaporate();
+    void evaporate_parallel();
+    void fill(const double value);
+    void clamp(const double lower, const double upper);
+    void normalize(const bool parallel);
+
+private:
+    size_t index(const int a, const int b) const { return (a > b ? row[a] + b : row[b] + a); }
+                                                            /// Returns the position of an edge inside `values`, which is in the row of its larger city
+    double bounded(const double value) const { return std::min(upper_bound, std::max(lower_bound, value)); }
+
+    const CandidateList& candidates;                        /// The candidate lists of the cities
+    std::vector<size_t> row;                                /// The offset of the row of each city inside `values`. The row of city `i` holds the edges to the cities up to `i`
+    float* values = nullptr;                                /// The rows of the lower triangle, each one padded to `PHERORMONE_ALIGNMENT` bytes, divided by `scale`
+    size_t n_values = 0;                                    /// The number of values of the buffer, including the padding
+    size_t n_bytes = 0;                                     /// The size of the allocation in bytes
+    double scale = 1.0;                                     /// The evaporation that has not been applied to the values yet
+    double lower_bound = 0.0;                               /// The lower bound of the pherormone of an edge, applied when the edge is read or deposited
+    double upper_bound = std::numeric_limits<double>::infinity();
+                                                            /// The upper bound of the pherormone of an edge, applied when the edge is read or deposited
+};
+
+/**
+ * The heuristic information eta^BETA of the candidate edges, which never changes, along with
+ * their choice information tau^ALPHA * eta^BETA, which is refreshed once per iteration.
+ *
+ * @note both tables are `n_points` x `k` arrays aligned with the candidate lists, so an ant step
+ *      loads the choice information of its city instead of evaluating its candidate edges.
+ *      The ants then see the pherormone of the candidate edges as it was at the start of the
+ *      iteration, as in the Ant System, which is exactly the case with buffered deposits.
+ */
+class ChoiceInfo
+{
+public:
+    ChoiceInfo(const CandidateList& candidates, const int n_points);
+
+    template <typename Store>
+    void refresh(const Store& pherormone);
+    template <typename Store>
+    void refresh_parallel(const Store& pherormone);
+    const double* choice_of(const int city) const { return choice.data() + (size_t)city * candidates.k; }
+                                                            /// Returns the choice information of the candidate edges of a city
+
+private:
+    const CandidateList& candidates;                        /// The candidate lists of the cities, which define the tabulated edges
+    std::vector<double> heuristic;                          /// The `n_points` x `k` heuristic information (1 / d) ^ BETA of the candidate edges
+    std::vector<double> choice;                             /// The `n_points` x `k` choice information of the candidate edges
+};
 
-void initialize_pherormone_matrix(std::vector<std::array<double, N_POINTS>>& pherormone_matrix);
+void initialize_pherormone_matrix(std::vector<std::vector<double>>& pherormone_matrix, const int n_points);
+int pherormone_store(const Settings& settings, const int n_points);
+
+/**
+ * Allocates the pherormone store selected at run time and runs a routine on it.
+ *
+ * @param[in] candidates the candidate lists of the cities (see `Candidates.h`)
+ * @param[in] n_points the number of cities
+ * @param[in] settings the run time settings (pherormone store and huge pages)
+ * @param[in] routine the callable that receives the store, written once for all the stores (ex. a generic lambda)
+ *
+ * @note the store is resolved once, and it is released as soon as the routine returns. A new store
+ *      only has to be added here, along with the explicit instantiations of the colonies.
+ */
+template <typename Routine>
+void with_pherormone_store(const CandidateList& candidates, const int n_points, const Settings& settings, Routine&& routine)
+{
+    const int store = pherormone_store(settings, n_points);
+    if (store == PHERORMONE_SPARSE)
+    {
+        SparsePherormone pherormone(candidates, n_points);  /// Declare the pherormone store of dimentions n_points x k
+        routine(pherormone);
+    }
+    else if (store == PHERORMONE_COMPACT)
+    {
+        CompactPherormone pherormone(candidates, n_points, settings.huge_pages);
+                                                            /// Declare the lower triangle of the pherormone matrix
+        routine(pherormone);
+    }
+    else
+    {
+        DensePherormone pherormone(candidates, n_points);   /// Declare the pherormone matrix of dimentions n_points x n_points
+        routine(pherormone);
+    }
+}
@@ -0,0 +1,73 @@
+#include "Random.h"
+
+/**
+ * Seeds the generator.
+ *
+ * @param[in] seed the seed, which is expanded to the 256 bits of the state with splitmix64
+ *
+ * @note splitmix64 never yields an all zero state, and it decorrelates seeds that differ in a few bits.
+ */
+Xoshiro256::Xoshiro256(const std::uint64_t seed)
+{
+    std::uint64_t x = seed;
+    for (std::uint64_t& word : state)
+    {
+        std::uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        word = z ^ (z >> 31);
+    }
+}
+
+/**
+ * Advances the generator by 2^128 numbers, which is the length of a stream.
+ */
+void Xoshiro256::jump()
+{
+    constexpr std::array<std::uint64_t, 4> polynomial = { 0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL };
+    std::array<std::uint64_t, 4> jumped = { 0, 0, 0, 0 };
+    for (const std::uint64_t word : polynomial)
+    {
+        for (int bit = 0; bit < 64; bit += 1)
+        {
+            if (word & (1ULL << bit))
+            {
+                for (int i = 0; i < 4; i += 1) { jumped[i] ^= state[i]; }
+            }
+            (*this)();
+        }
+    }
+    state = jumped;
+}
+
+/**
+ * Creates the generator of a stream.
+ *
+ * @param[in] seed the seed of the run (see `Settings::seed`)
+ * @param[in] stream the stream (see `STREAM_*`)
+ *
+ * @return a generator positioned at the beginning of the stream
+ *
+ * @note a jump costs 256 steps of the generator, so the streams are meant to be created once,
+ *      outside of the hot loops.
+ */
+Xoshiro256 random_stream(const std::uint64_t seed, const int stream)
+{
+    Xoshiro256 gen(seed);
+    for (int i = 0; i < stream; i += 1)
+    {
+        gen.jump();
+    }
+    return gen;
+}
+
+/**
+ * Draws a seed from the non-deterministic generator of the platform.
+ *
+ * @return a 64 bit seed
+ */
+std::uint64_t random_seed()
+{
+    std::random_device rd;                                  /// non-deterministic generator
+    return ((std::uint64_t)rd() << 32) ^ (std::uint64_t)rd();
+}
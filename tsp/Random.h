@@ -0,0 +1,62 @@
+/**
+ * Random.h
+ *
+ * In this header file, we define the random generator of
+ * the project, which is xoshiro256**. Every random choice
+ * of a run is derived from a single seed (see `--seed`),
+ * so a run can be repeated bit for bit. The seed selects a
+ * sequence of 2^256 - 1 numbers, and the jump function of
+ * the generator splits that sequence into streams of 2^128
+ * numbers that never overlap. Each consumer (the dataset,
+ * the serial part of an algorithm, and every thread or ant
+ * of a parallel algorithm) owns a stream, so the threads
+ * never share a generator and a parallel run yields the
+ * same result regardless of the order of the threads.
+ *
+ * @remark https://prng.di.unimi.it/
+ * @remark https://arxiv.org/abs/1805.01407
+ */
+
+#pragma once
+
+#include "Common.h"
+
+constexpr int STREAM_CITIES = 0;                            /// The stream that generates the random dataset
+constexpr int STREAM_MAIN = 1;                              /// The stream of the serial part of the algorithms
+constexpr int STREAM_THREADS = 2;                           /// The first stream of the threads (or ants) of the algorithms. Thread `i` owns stream `STREAM_THREADS` + `i`
+
+/**
+ * The xoshiro256** generator, which satisfies the requirements of a uniform random bit generator,
+ * so it can drive the distributions of the standard library.
+ */
+class Xoshiro256
+{
+public:
+    using result_type = std::uint64_t;
+
+    explicit Xoshiro256(const std::uint64_t seed = 0);
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+    result_type operator()()
+    {
+        const std::uint64_t result = rotl(state[1] * 5, 7) * 9;
+        const std::uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+    void jump();
+
+private:
+    static std::uint64_t rotl(const std::uint64_t x, const int k) { return (x << k) | (x >> (64 - k)); }
+
+    std::array<std::uint64_t, 4> state;                     /// The state of the generator, which is never all zeros
+};
+
+Xoshiro256 random_stream(const std::uint64_t seed, const int stream);
+std::uint64_t random_seed();
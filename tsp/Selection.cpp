@@ -0,0 +1,94 @@
+#include "Selection.h"
+
+/**
+ * Selects an edge among the `ROULETTE_SIZE` best ones, like `roulette_wheel()`, without sorting all the evaluations.
+ *
+ * @param[in, out] evaluation the precomputed edge evaluations, which are reordered and truncated
+ * @param[in] roulette_random the precomputed ramdom selection probability
+ *
+ * @return the index of the next node for the ant to go
+ *
+ * @note `std::nth_element` moves the best `ROULETTE_SIZE` evaluations to the end of the vector in O(n),
+ *      and only those are sorted, so the wheel that follows is the wheel of `roulette_wheel()`.
+ */
+int select_top_k(std::vector<std::pair<int, double>>& evaluation, const double roulette_random)
+{
+    if (evaluation.size() > ROULETTE_SIZE)
+    {
+        std::nth_element(evaluation.begin(), evaluation.end() - ROULETTE_SIZE, evaluation.end(), sortbysec_dbl);
+                                                                                /// Partitions the best evaluations to the end
+        evaluation.erase(evaluation.begin(), evaluation.end() - ROULETTE_SIZE);
+    }
+    return roulette_wheel(evaluation, roulette_random);                         /// Sorts at most `ROULETTE_SIZE` evaluations
+}
+
+/**
+ * Selects an edge with probability proportional to its evaluation.
+ *
+ * @param[in] evaluation the precomputed edge evaluations
+ * @param[in] roulette_random the precomputed ramdom selection probability
+ *
+ * @return the index of the next node for the ant to go
+ *
+ * @note the sum of the evaluations is vectorized, and the wheel then stops at the first edge whose
+ *      prefix sum exceeds the random share of the sum, so the evaluations are scanned at most twice.
+ */
+int select_proportional(const std::vector<std::pair<int, double>>& evaluation, const double roulette_random)
+{
+    const int n_edges = (int)evaluation.size();
+    const std::pair<int, double>* edges = evaluation.data();
+    double total = 0.0;
+#pragma omp simd reduction(+ : total)
+    for (int m = 0; m < n_edges; m += 1)
+    {
+        total += edges[m].second;
+    }
+    const double target = roulette_random * total;
+    double accumulator = 0.0;
+    for (int m = 0; m < n_edges; m += 1)
+    {
+        accumulator += edges[m].second;
+        if (accumulator > target) { return edges[m].first; }
+    }
+    return edges[n_edges - 1].first;                                            /// The rounding of the sums may leave the target past the last prefix sum
+}
+
+/**
+ * Selects the best edge among `ROULETTE_SIZE` edges drawn at random.
+ *
+ * @param[in] evaluation the precomputed edge evaluations
+ * @param[in, out] gen the random stream of the ant
+ *
+ * @return the index of the next node for the ant to go
+ *
+ * @note the edges are drawn with replacement, so the cost does not depend on the number of evaluations.
+ */
+int select_tournament(const std::vector<std::pair<int, double>>& evaluation, Xoshiro256& gen)
+{
+    std::uniform_int_distribution<int> edge_dist(0, (int)evaluation.size() - 1);
+    int winner = edge_dist(gen);
+    for (int m = 1; m < ROULETTE_SIZE; m += 1)
+    {
+        const int contender = edge_dist(gen);
+        if (evaluation[contender].second > evaluation[winner].second) { winner = contender; }
+    }
+    return evaluation[winner].first;
+}
+
+/**
+ * Selects an edge for the ant to follow with the selection method chosen at run time.
+ *
+ * @param[in, out] evaluation the precomputed edge evaluations, which may be reordered
+ * @param[in] selection the selection method (see `SELECTION_*` in Common.h)
+ * @param[in, out] gen the random stream of the ant
+ *
+ * @return the index of the next node for the ant to go
+ */
+int select_edge(std::vector<std::pair<int, double>>& evaluation, const int selection, Xoshiro256& gen)
+{
+    if (selection == SELECTION_TOURNAMENT) { return select_tournament(evaluation, gen); }
+    const double roulette_random = std::uniform_real_distribution<double>(0, 1)(gen);
+    if (selection == SELECTION_PROPORTIONAL) { return select_proportional(evaluation, roulette_random); }
+    if (selection == SELECTION_SORT) { return roulette_wheel(evaluation, roulette_random); }
+    return select_top_k(evaluation, roulette_random);
+}
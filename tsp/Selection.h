@@ -0,0 +1,32 @@
+/**
+ * Selection.h
+ *
+ * In this header file, we define the selection methods
+ * that pick the next city of an ant among the evaluated
+ * edges. The original roulette wheel (see `Naive.h`) sorts
+ * all the evaluations in every step, which costs O(n log n)
+ * once all the candidates of a city have been explored.
+ * The methods below cost O(n) or less:
+ *  - top-k: partitions the `ROULETTE_SIZE` best edges with
+ *    `std::nth_element` and spins the original wheel on
+ *    them, so it chooses like the original wheel, up to
+ *    the order of equal evaluations
+ *  - proportional: spins a wheel on all the edges, with a
+ *    vectorized sum and a single scan over the prefix sums
+ *  - tournament: draws `ROULETTE_SIZE` edges at random and
+ *    follows the best of them, which costs O(1)
+ *
+ * @remark https://en.wikipedia.org/wiki/Fitness_proportionate_selection
+ * @remark https://en.wikipedia.org/wiki/Tournament_selection
+ */
+
+#pragma once
+
+#include "Common.h"
+#include "Naive.h"
+#include "Random.h"
+
+int select_top_k(std::vector<std::pair<int, double>>& evaluation, const double roulette_random);
+int select_proportional(const std::vector<std::pair<int, double>>& evaluation, const double roulette_random);
+int select_tournament(const std::vector<std::pair<int, double>>& evaluation, Xoshiro256& gen);
+int select_edge(std::vector<std::pair<int, double>>& evaluation, const int selection, Xoshiro256& gen);
@@ -0,0 +1,294 @@
+#include "Tour.h"
+
+/**
+ * Reverses a cyclic range of an array, or its complement if the complement is shorter.
+ *
+ * @param[in, out] items the array
+ * @param[in, out] positions the position of each item inside `items`
+ * @param[in] i the position of the first item of the range
+ * @param[in] j the position of the last item of the range
+ * @param[in] visit a function called for every item that was moved (including the middle item of an odd range)
+ *
+ * @note reversing a range of a cycle yields the same cycle as reversing its complement,
+ *      so the shorter of the two is reversed. That way a reversal costs at most n / 2 swaps.
+ */
+template <typename Visit>
+void reverse_cyclic(std::vector<int>& items, std::vector<int>& positions, int i, int j, Visit visit)
+{
+    const int n_items = (int)items.size();
+    int length = (j - i + n_items) % n_items + 1;           /// The number of items in the range
+    if (2 * length > n_items)                               /// Reverse the complement of the range instead
+    {
+        i = (j + 1) % n_items;
+        j = (i + n_items - length - 1) % n_items;
+        length = n_items - length;
+    }
+    for (int k = 0; k < length; k += 1)
+    {
+        visit(items[(i + k) % n_items]);
+    }
+    for (int swaps = length / 2; swaps > 0; swaps -= 1)
+    {
+        std::swap(items[i], items[j]);
+        positions[items[i]] = i;
+        positions[items[j]] = j;
+        i = (i + 1 == n_items ? 0 : i + 1);
+        j = (j == 0 ? n_items - 1 : j - 1);
+    }
+}
+
+/**
+ * Stores a TSP route, choosing the representation with respect to its size.
+ *
+ * @param[in] tsp_route the TSP route, which must visit every city once
+ *
+ * @note routes of at least `TWO_LEVEL_THRESHOLD` cities are stored as a two-level list.
+ */
+Tour::Tour(const std::vector<int>& tsp_route) : n_points((int)tsp_route.size()), two_level((int)tsp_route.size() >= TWO_LEVEL_THRESHOLD)
+{
+    if (!two_level)
+    {
+        route = tsp_route;
+        position.resize(n_points);
+        for (int i = 0; i < n_points; i += 1)
+        {
+            position[route[i]] = i;
+        }
+        return;
+    }
+    segment_size = std::max(8, (int)std::sqrt((double)n_points));
+    segment.resize(n_points);
+    index.resize(n_points);
+    build(tsp_route);
+}
+
+/**
+ * Splits a route into segments of `segment_size` cities.
+ *
+ * @param[in] tsp_route the TSP route
+ */
+void Tour::build(const std::vector<int>& tsp_route)
+{
+    const int n_segments = (n_points + segment_size - 1) / segment_size;
+    members.assign(n_segments, std::vector<int>());
+    reversed.assign(n_segments, 0);
+    order.resize(n_segments);
+    rank.resize(n_segments);
+    std::iota(order.begin(), order.end(), 0);
+    std::iota(rank.begin(), rank.end(), 0);
+    for (int i = 0; i < n_points; i += 1)
+    {
+        const int part = i / segment_size;
+        segment[tsp_route[i]] = part;
+        index[tsp_route[i]] = (int)members[part].size();
+        members[part].push_back(tsp_route[i]);
+    }
+}
+
+/**
+ * Finds the successor of a city.
+ *
+ * @param[in] city the city
+ *
+ * @return the city that follows `city` in the route
+ */
+int Tour::next(const int city) const
+{
+    if (!two_level) { return route[position[city] + 1 == n_points ? 0 : position[city] + 1]; }
+    const int part = segment[city];
+    const int offset = logical(city);
+    if (offset + 1 < (int)members[part].size()) { return city_at(part, offset + 1); }
+    return city_at(order[rank[part] + 1 == (int)order.size() ? 0 : rank[part] + 1], 0);
+                                                            /// The first city of the next segment
+}
+
+/**
+ * Finds the predecessor of a city.
+ *
+ * @param[in] city the city
+ *
+ * @return the city that precedes `city` in the route
+ */
+int Tour::prev(const int city) const
+{
+    if (!two_level) { return route[position[city] == 0 ? n_points - 1 : position[city] - 1]; }
+    const int part = segment[city];
+    const int offset = logical(city);
+    if (offset > 0) { return city_at(part, offset - 1); }
+    const int previous = order[rank[part] == 0 ? order.size() - 1 : rank[part] - 1];
+    return city_at(previous, (int)members[previous].size() - 1);
+                                                            /// The last city of the previous segment
+}
+
+/**
+ * Checks the relative order of 3 cities.
+ *
+ * @param[in] a the first city
+ * @param[in] b the second city
+ * @param[in] c the third city
+ *
+ * @return true if `b` lies on the path that starts at `a`, follows the successors and ends at `c`
+ */
+bool Tour::between(const int a, const int b, const int c) const
+{
+    auto key = [&](const int city)                          /// The position of a city in the route, up to a rotation
+    {
+        return (two_level ? (long long)rank[segment[city]] * n_points + logical(city) : (long long)position[city]);
+    };
+    const long long key_a = key(a);
+    const long long key_b = key(b);
+    const long long key_c = key(c);
+    if (key_a <= key_c) { return key_a <= key_b && key_b <= key_c; }
+    return key_b >= key_a || key_b <= key_c;                /// The path wraps around the end of the route
+}
+
+/**
+ * Applies a 2-opt move, which replaces the edges (a, b) and (c, d) with the edges (a, c) and (b, d).
+ *
+ * @param[in] a the first city of the first edge
+ * @param[in] b the second city of the first edge
+ * @param[in] c the first city of the second edge
+ * @param[in] d the second city of the second edge
+ *
+ * @note `b` and `d` must lie on the same side of `a` and `c` respectively, that is either `b` and `d`
+ *      succeed `a` and `c`, or `b` and `d` precede `a` and `c`. The direction of the route is irrelevant,
+ *      so the moves can be chained even if a previous move reversed the complement of its path.
+ */
+void Tour::flip(const int a, const int b, const int c, const int d)
+{
+    if (next(a) == b) { reverse(b, c); }
+    else { reverse(a, d); }
+}
+
+/**
+ * Reverses the path of the route that starts at a city and ends at another city.
+ *
+ * @param[in] first the first city of the path
+ * @param[in] last the last city of the path
+ *
+ * @remark for the two-level list:
+ *      - If the path (or its complement) lies inside a segment, reverse it inside the segment
+ *      - Else split the segments so that the path starts and ends at segment boundaries
+ *      -   Reverse the order of the segments of the path and toggle their reversal bits
+ *      -   Rebuild the list, once the splits have created too many small segments
+ */
+void Tour::reverse(const int first, const int last)
+{
+    if (!two_level)
+    {
+        reverse_cyclic(route, position, position[first], position[last], [](const int) {});
+        return;
+    }
+    if (segment[first] == segment[last])
+    {
+        const int offset_first = logical(first);
+        const int offset_last = logical(last);
+        if (offset_first <= offset_last) { reverse_segment(segment[first], offset_first, offset_last); }
+        else if (offset_last + 1 < offset_first) { reverse_segment(segment[first], offset_last + 1, offset_first - 1); }
+                                                            /// The complement of the path lies inside the segment
+        return;
+    }
+    split(first);                                           /// `first` becomes the first city of its segment
+    split(next(last));                                      /// `last` becomes the last city of its segment
+    reverse_cyclic(order, rank, rank[segment[first]], rank[segment[last]], [&](const int part) { reversed[part] ^= 1; });
+    if ((int)order.size() > 2 * ((n_points + segment_size - 1) / segment_size))
+    {
+        std::vector<int> tsp_route;
+        to_route(tsp_route);
+        build(tsp_route);
+    }
+}
+
+/**
+ * Reverses a range of cities inside a segment.
+ *
+ * @param[in] part the segment
+ * @param[in] begin the position (in route order) of the first city of the range inside the segment
+ * @param[in] end the position (in route order) of the last city of the range inside the segment
+ */
+void Tour::reverse_segment(const int part, int begin, int end)
+{
+    std::vector<int>& cities = members[part];
+    if (reversed[part])                                     /// Convert the positions to the order of `members`
+    {
+        const int size = (int)cities.size();
+        std::swap(begin, end);
+        begin = size - 1 - begin;
+        end = size - 1 - end;
+    }
+    std::reverse(cities.begin() + begin, cities.begin() + end + 1);
+    for (int i = begin; i <= end; i += 1)
+    {
+        index[cities[i]] = i;
+    }
+}
+
+/**
+ * Splits the segment of a city, so that the city becomes the first city of a segment.
+ *
+ * @param[in] city the city
+ *
+ * @note the shorter of the 2 parts is moved to a new segment, so a split costs O(sqrt(n)).
+ */
+void Tour::split(const int city)
+{
+    const int part = segment[city];
+    const int offset = logical(city);
+    const int size = (int)members[part].size();
+    if (offset == 0) { return; }
+    const bool move_tail = (size - offset <= offset);       /// Move the cities from `city` onwards, else the cities before `city`
+    std::vector<int> moved;
+    for (int i = (move_tail ? offset : 0); i < (move_tail ? size : offset); i += 1)
+    {
+        moved.push_back(city_at(part, i));
+    }
+    std::vector<int>& kept = members[part];
+    if (move_tail != (bool)reversed[part]) { kept.resize(size - moved.size()); }
+                                                            /// The moved cities are stored at the end of `members`
+    else
+    {
+        kept.erase(kept.begin(), kept.begin() + moved.size());
+        for (int i = 0; i < (int)kept.size(); i += 1)
+        {
+            index[kept[i]] = i;
+        }
+    }
+    const int created = (int)members.size();
+    for (int i = 0; i < (int)moved.size(); i += 1)
+    {
+        segment[moved[i]] = created;
+        index[moved[i]] = i;
+    }
+    members.push_back(std::move(moved));
+    reversed.push_back(0);
+    rank.push_back(0);
+    const int at = (move_tail ? rank[part] + 1 : rank[part]);
+    order.insert(order.begin() + at, created);
+    for (int i = at; i < (int)order.size(); i += 1)
+    {
+        rank[order[i]] = i;
+    }
+}
+
+/**
+ * Exports the route.
+ *
+ * @param[in, out] tsp_route the cities in route order
+ */
+void Tour::to_route(std::vector<int>& tsp_route) const
+{
+    if (!two_level)
+    {
+        tsp_route = route;
+        return;
+    }
+    tsp_route.clear();
+    tsp_route.reserve(n_points);
+    for (const int part : order)
+    {
+        for (int i = 0; i < (int)members[part].size(); i += 1)
+        {
+            tsp_route.push_back(city_at(part, i));
+        }
+    }
+}
@@ -0,0 +1,64 @@
+/**
+ * Tour.h
+ *
+ * In this header file, we define the representation of the
+ * TSP route that the local search engines modify. A route
+ * is a cycle, so it only exposes the successor (`next`) and
+ * the predecessor (`prev`) of a city, the relative order of
+ * 3 cities (`between`) and the 2-opt move (`flip`), which
+ * reverses a path of the route. Small routes are stored as
+ * an array along with the position of each city, where a
+ * flip costs O(n). Large routes are stored as a two-level
+ * list: the route is split into about sqrt(n) segments,
+ * each segment has a reversal bit, and a flip only splits
+ * the 2 segments at its ends and reverses the order of the
+ * segments in between, which costs O(sqrt(n)).
+ *
+ * @remark https://pubsonline.informs.org/doi/10.1287/ijoc.7.2.151
+ */
+
+#pragma once
+
+#include "Common.h"
+
+/**
+ * A TSP route that supports the queries and the moves of the local search.
+ *
+ * @note the direction of the route is not significant. A flip may reverse the
+ *      complement of the requested path, which yields the same cycle.
+ */
+class Tour
+{
+public:
+    explicit Tour(const std::vector<int>& tsp_route);
+
+    int size() const { return n_points; }
+    int next(const int city) const;
+    int prev(const int city) const;
+    bool between(const int a, const int b, const int c) const;
+    void flip(const int a, const int b, const int c, const int d);
+    void to_route(std::vector<int>& tsp_route) const;
+    bool is_two_level() const { return two_level; }
+
+private:
+    void reverse(const int first, const int last);
+    void reverse_segment(const int segment, int begin, int end);
+    void split(const int city);
+    void build(const std::vector<int>& tsp_route);
+    int logical(const int city) const { return reversed[segment[city]] ? (int)members[segment[city]].size() - 1 - index[city] : index[city]; }
+    int city_at(const int part, const int offset) const { return members[part][reversed[part] ? members[part].size() - 1 - offset : offset]; }
+
+    int n_points;                                           /// The number of cities
+    bool two_level;                                         /// If true, the route is stored as a two-level list, else as an array
+
+    std::vector<int> route;                                 /// The cities in route order (array representation)
+    std::vector<int> position;                              /// The position of each city inside `route` (array representation)
+
+    int segment_size;                                       /// The number of cities of each segment when the two-level list is (re)built
+    std::vector<std::vector<int>> members;                  /// The cities of each segment, in the order of the segment when it is not reversed
+    std::vector<char> reversed;                             /// The reversal bit of each segment
+    std::vector<int> order;                                 /// The segments in route order
+    std::vector<int> rank;                                  /// The position of each segment inside `order`
+    std::vector<int> segment;                               /// The segment of each city
+    std::vector<int> index;                                 /// The position of each city inside the `members` of its segment
+};
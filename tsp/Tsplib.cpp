@@ -0,0 +1,443 @@
+#include "Tsplib.h"
+
+#include <charconv>                                         /// std::from_chars
+#include <string_view>                                      /// std::string_view
+
+#if defined(_WIN32)
+#include <windows.h>                                        /// CreateFileMapping, MapViewOfFile
+#else
+#include <fcntl.h>                                          /// open
+#include <unistd.h>                                         /// close
+#include <sys/mman.h>                                       /// mmap, madvise
+#include <sys/stat.h>                                       /// fstat
+#endif
+
+/**
+ * A read only memory mapping of a whole file.
+ *
+ * @note the mapping is released when the object goes out of scope.
+ */
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::string& filename)
+    {
+#if defined(_WIN32)
+        file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) { return; }
+        LARGE_INTEGER file_size;
+        if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) { return; }
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr) { return; }
+        data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        length = (data == nullptr ? 0 : (size_t)file_size.QuadPart);
+#else
+        const int descriptor = open(filename.c_str(), O_RDONLY);
+        if (descriptor < 0) { return; }
+        struct stat status;
+        if (fstat(descriptor, &status) == 0 && status.st_size > 0)
+        {
+            void* address = mmap(nullptr, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+            if (address != MAP_FAILED)
+            {
+                madvise(address, (size_t)status.st_size, MADV_SEQUENTIAL);
+                                                            /// The file is parsed once from the beginning to the end
+                madvise(address, (size_t)status.st_size, MADV_WILLNEED);
+                                                            /// The advice values are not flags, so each one is given apart
+                data = static_cast<const char*>(address);
+                length = (size_t)status.st_size;
+            }
+        }
+        close(descriptor);                                  /// The mapping stays valid after the descriptor is closed
+#endif
+    }
+
+    ~MappedFile()
+    {
+#if defined(_WIN32)
+        if (data != nullptr) { UnmapViewOfFile(data); }
+        if (mapping != nullptr) { CloseHandle(mapping); }
+        if (file != INVALID_HANDLE_VALUE) { CloseHandle(file); }
+#else
+        if (data != nullptr) { munmap(const_cast<char*>(data), length); }
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool is_open() const { return data != nullptr; }
+    const char* begin() const { return data; }
+    const char* end() const { return data + length; }
+
+private:
+    const char* data = nullptr;                             /// The first byte of the mapped file
+    size_t length = 0;                                      /// The size of the mapped file in bytes
+#if defined(_WIN32)
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#endif
+};
+
+/**
+ * A read position inside a memory mapped TSPLIB file.
+ */
+struct Cursor
+{
+    const char* position;                                   /// The next character to be parsed
+    const char* end;                                        /// One past the last character of the file
+
+    bool eof() const { return position >= end; }
+    void skip_blanks() { while (position < end && (*position == ' ' || *position == '\t' || *position == '\r')) { position += 1; } }
+    void skip_whitespace() { while (position < end && std::isspace((unsigned char)*position)) { position += 1; } }
+    void skip_line() { while (position < end && *position != '\n') { position += 1; } position += (position < end ? 1 : 0); }
+};
+
+/**
+ * Reads a keyword (ex. `DIMENSION` or `NODE_COORD_SECTION`) from a TSPLIB file.
+ *
+ * @param[in, out] cursor the read position, which is moved past the keyword
+ *
+ * @return the keyword, without a possible trailing colon, which is empty at the end of the file or at a colon
+ */
+std::string_view read_keyword(Cursor& cursor)
+{
+    cursor.skip_whitespace();
+    const char* first = cursor.position;
+    while (!cursor.eof() && !std::isspace((unsigned char)*cursor.position) && *cursor.position != ':')
+    {
+        cursor.position += 1;
+    }
+    return std::string_view(first, cursor.position - first);
+}
+
+/**
+ * Reads the value of a TSPLIB specification entry (ex. `EUC_2D` in `EDGE_WEIGHT_TYPE : EUC_2D`).
+ *
+ * @param[in, out] cursor the read position, which is moved to the next line
+ *
+ * @return the value, trimmed of surrounding blanks
+ */
+std::string_view read_value(Cursor& cursor)
+{
+    cursor.skip_blanks();
+    if (!cursor.eof() && *cursor.position == ':') { cursor.position += 1; }
+    cursor.skip_blanks();
+    const char* first = cursor.position;
+    cursor.skip_line();
+    const char* last = cursor.position;
+    while (last > first && std::isspace((unsigned char)*(last - 1))) { last -= 1; }
+    return std::string_view(first, last - first);
+}
+
+/**
+ * Parses a number in place.
+ *
+ * @param[in, out] cursor the read position, which is moved past the number
+ * @param[out] value the parsed number
+ *
+ * @return false if there was no number to parse, else true
+ */
+template <typename T>
+bool read_number(Cursor& cursor, T& value)
+{
+    cursor.skip_whitespace();
+    if (!cursor.eof() && *cursor.position == '+') { cursor.position += 1; }
+                                                            /// std::from_chars() does not accept a leading plus sign
+    const std::from_chars_result result = std::from_chars(cursor.position, cursor.end, value);
+    if (result.ec != std::errc()) { return false; }
+    cursor.position = result.ptr;
+    return true;
+}
+
+/**
+ * Skips the contents of a TSPLIB section that the project does not use (ex. `FIXED_EDGES_SECTION`).
+ *
+ * @param[in, out] cursor the read position, which is moved to the next keyword
+ */
+void skip_section(Cursor& cursor)
+{
+    cursor.skip_line();
+    for (;;)
+    {
+        cursor.skip_whitespace();
+        if (cursor.eof() || !(std::isdigit((unsigned char)*cursor.position) || *cursor.position == '-' || *cursor.position == '+' || *cursor.position == '.'))
+        {
+            return;                                         /// A keyword follows
+        }
+        cursor.skip_line();
+    }
+}
+
+/**
+ * Prints a warning about a malformed TSPLIB file.
+ *
+ * @param[in] filename the name of the file
+ * @param[in] message the description of the fault
+ *
+ * @return false, so that the loaders can return the call directly
+ */
+bool tsplib_warning(const std::string& filename, const std::string& message)
+{
+    std::cout << "[Warning]: " << message << " in \"" << filename << "\"\n\t[\"Invalid TSPLIB file\" fault masked]" << std::endl;
+    return false;
+}
+
+/**
+ * Reads the explicit distance matrix of a TSPLIB instance.
+ *
+ * @param[in, out] cursor the read position, which is moved past the matrix
+ * @param[in] format the value of the `EDGE_WEIGHT_FORMAT` entry
+ * @param[in, out] cities the instance whose `weights` are filled
+ *
+ * @return false if the format is not supported or the matrix is incomplete, else true
+ *
+ * @note the column-wise formats of a symmetric matrix enumerate the same entries
+ *      as the row-wise formats of the opposite triangle.
+ */
+bool read_edge_weights(Cursor& cursor, const std::string_view format, Instance& cities)
+{
+    const size_t n_points = cities.size();
+    bool upper = false, diagonal = false;
+    if (format == "FULL_MATRIX")
+    {
+        cities.weights.assign(n_points * n_points, 0.0);
+        for (size_t i = 0; i < n_points * n_points; i += 1)
+        {
+            if (!read_number(cursor, cities.weights[i])) { return false; }
+        }
+        return true;
+    }
+    else if (format == "UPPER_ROW" || format == "LOWER_COL") { upper = true; }
+    else if (format == "LOWER_ROW" || format == "UPPER_COL") { upper = false; }
+    else if (format == "UPPER_DIAG_ROW" || format == "LOWER_DIAG_COL") { upper = true; diagonal = true; }
+    else if (format == "LOWER_DIAG_ROW" || format == "UPPER_DIAG_COL") { upper = false; diagonal = true; }
+    else { return false; }
+
+    cities.weights.assign(n_points * n_points, 0.0);
+    for (size_t i = 0; i < n_points; i += 1)
+    {
+        const size_t first = (upper ? (diagonal ? i : i + 1) : 0);
+        const size_t last = (upper ? n_points : (diagonal ? i + 1 : i));
+        for (size_t j = first; j < last; j += 1)
+        {
+            double weight;
+            if (!read_number(cursor, weight)) { return false; }
+            cities.weights[i * n_points + j] = weight;      /// Mirror every entry, since TSPLIB triangular matrices are symmetric
+            cities.weights[j * n_points + i] = weight;
+        }
+    }
+    return true;
+}
+
+/**
+ * Loads a TSPLIB instance (`.tsp` file).
+ *
+ * @param[in] filename the path to the TSPLIB instance
+ * @param[in, out] cities the instance to be loaded
+ *
+ * @return false if the file could not be loaded, else true
+ *
+ * @note the supported edge weight types are `EUC_2D`, `CEIL_2D`, `ATT`, `GEO` and
+ *      `EXPLICIT`. For `EXPLICIT` instances the coordinates are read from the
+ *      `DISPLAY_DATA_SECTION` if one is present, else they are set to zero.
+ */
+bool load_tsplib_instance(const std::string filename, Instance& cities)
+{
+    MappedFile file(filename);
+    if (!file.is_open())
+    {
+        std::cout << "[Warning]: Could not open \"" << filename << "\"\n\t[\"File not found\" fault masked]" << std::endl;
+        return false;
+    }
+
+    Cursor cursor = { file.begin(), file.end() };
+    Instance loaded;
+    int n_points = 0;
+    std::string_view weight_type = "EUC_2D";
+    std::string_view weight_format;
+    bool has_coordinates = false;
+
+    while (!cursor.eof())
+    {
+        const std::string_view keyword = read_keyword(cursor);
+        if (keyword.empty())                                /// Only the trailing whitespace of the file or a stray colon leave the keyword empty
+        {
+            if (cursor.eof()) { break; }
+            return tsplib_warning(filename, "Missing keyword before \":\"");
+        }
+        if (keyword == "EOF") { break; }
+        if (keyword == "NODE_COORD_SECTION" || keyword == "DISPLAY_DATA_SECTION")
+        {
+            if (n_points <= 0) { return tsplib_warning(filename, "Section \"" + std::string(keyword) + "\" precedes \"DIMENSION\""); }
+            cursor.skip_line();
+            for (int i = 0; i < n_points; i += 1)
+            {
+                int node;
+                double x, y;
+                if (!read_number(cursor, node) || !read_number(cursor, x) || !read_number(cursor, y))
+                {
+                    return tsplib_warning(filename, "Malformed coordinates");
+                }
+                if (node < 1 || node > n_points) { return tsplib_warning(filename, "Node " + std::to_string(node) + " out of range"); }
+                loaded.x[node - 1] = x;                     /// The coordinates are stored straight into the structure of arrays
+                loaded.y[node - 1] = y;
+            }
+            has_coordinates = true;
+        }
+        else if (keyword == "EDGE_WEIGHT_SECTION")
+        {
+            if (n_points <= 0) { return tsplib_warning(filename, "Section \"EDGE_WEIGHT_SECTION\" precedes \"DIMENSION\""); }
+            cursor.skip_line();
+            if (!read_edge_weights(cursor, weight_format, loaded))
+            {
+                return tsplib_warning(filename, "Unsupported or incomplete \"EDGE_WEIGHT_FORMAT\" (" + std::string(weight_format) + ")");
+            }
+        }
+        else if (keyword.size() > 8 && keyword.substr(keyword.size() - 8) == "_SECTION")
+        {
+            skip_section(cursor);                           /// Sections that are not used by the project (ex. `FIXED_EDGES_SECTION`)
+        }
+        else
+        {
+            const std::string_view value = read_value(cursor);
+            if (keyword == "NAME") { loaded.name = std::string(value); }
+            else if (keyword == "TYPE" && value != "TSP") { return tsplib_warning(filename, "Unsupported problem type \"" + std::string(value) + "\""); }
+            else if (keyword == "EDGE_WEIGHT_TYPE") { weight_type = value; }
+            else if (keyword == "EDGE_WEIGHT_FORMAT") { weight_format = value; }
+            else if (keyword == "DIMENSION")
+            {
+                if (std::from_chars(value.data(), value.data() + value.size(), n_points).ec != std::errc() || n_points < 3)
+                {
+                    return tsplib_warning(filename, "Invalid \"DIMENSION\"");
+                }
+                loaded.resize(n_points);
+            }
+        }
+    }
+
+    if (weight_type == "EUC_2D") { loaded.metric = Metric::EUC_2D; }
+    else if (weight_type == "CEIL_2D") { loaded.metric = Metric::CEIL_2D; }
+    else if (weight_type == "ATT") { loaded.metric = Metric::ATT; }
+    else if (weight_type == "GEO") { loaded.metric = Metric::GEO; }
+    else if (weight_type == "EXPLICIT") { loaded.metric = Metric::EXPLICIT; }
+    else { return tsplib_warning(filename, "Unsupported \"EDGE_WEIGHT_TYPE\" (" + std::string(weight_type) + ")"); }
+
+    if (n_points <= 0) { return tsplib_warning(filename, "Missing \"DIMENSION\""); }
+    if (loaded.metric == Metric::EXPLICIT && loaded.weights.empty()) { return tsplib_warning(filename, "Missing \"EDGE_WEIGHT_SECTION\""); }
+    if (loaded.metric != Metric::EXPLICIT && !has_coordinates) { return tsplib_warning(filename, "Missing \"NODE_COORD_SECTION\""); }
+
+    cities = std::move(loaded);
+    return true;
+}
+
+/**
+ * Loads a TSPLIB tour (`.tour` file) of an instance.
+ *
+ * @param[in] filename the path to the TSPLIB tour
+ * @param[in] cities the instance that the tour visits
+ * @param[in, out] tsp_route the node indexes of the tour with respect to `cities` variable
+ *
+ * @return false if the file could not be loaded or is not a tour of `cities`, else true
+ *
+ * @note the nodes of the file are the original identifiers of the cities,
+ *      so the tour is valid even if the cities were reordered by an algorithm.
+ */
+bool load_tsplib_tour(const std::string filename, const Instance& cities, std::vector<int>& tsp_route)
+{
+    MappedFile file(filename);
+    if (!file.is_open())
+    {
+        std::cout << "[Warning]: Could not open \"" << filename << "\"\n\t[\"File not found\" fault masked]" << std::endl;
+        return false;
+    }
+
+    const int n_points = cities.size();
+    std::vector<int> position(n_points);                    /// Maps the original identifier of a city to its current index
+    for (int i = 0; i < n_points; i += 1)
+    {
+        position[cities.id[i]] = i;
+    }
+
+    Cursor cursor = { file.begin(), file.end() };
+    std::vector<char> visited(n_points, 0);
+    tsp_route.clear();
+    tsp_route.reserve(n_points);
+    while (!cursor.eof())
+    {
+        const std::string_view keyword = read_keyword(cursor);
+        if (keyword.empty())                                /// Only the trailing whitespace of the file or a stray colon leave the keyword empty
+        {
+            if (cursor.eof()) { break; }
+            return tsplib_warning(filename, "Missing keyword before \":\"");
+        }
+        if (keyword == "EOF") { break; }
+        if (keyword == "TOUR_SECTION")
+        {
+            cursor.skip_line();
+            int node;
+            while (read_number(cursor, node) && node != -1)
+            {
+                if (node < 1 || node > n_points || visited[node - 1])
+                {
+                    return tsplib_warning(filename, "Node " + std::to_string(node) + " out of range or visited twice");
+                }
+                visited[node - 1] = 1;
+                tsp_route.emplace_back(position[node - 1]);
+            }
+        }
+        else if (keyword.size() > 8 && keyword.substr(keyword.size() - 8) == "_SECTION")
+        {
+            skip_section(cursor);
+        }
+        else
+        {
+            const std::string_view value = read_value(cursor);
+            if (keyword == "TYPE" && value != "TOUR") { return tsplib_warning(filename, "Unsupported file type \"" + std::string(value) + "\""); }
+        }
+    }
+    if ((int)tsp_route.size() != n_points)
+    {
+        return tsplib_warning(filename, "Tour visits " + std::to_string(tsp_route.size()) + " of " + std::to_string(n_points) + " cities");
+    }
+    return true;
+}
+
+/**
+ * Exports a tour to a TSPLIB tour (`.tour` file).
+ *
+ * @param[in] filename the path to the TSPLIB tour
+ * @param[in] cities the instance that the tour visits
+ * @param[in] tsp_route the node indexes of the tour with respect to `cities` variable
+ *
+ * @return false if the file could not be written, else true
+ *
+ * @note the nodes are written using the original identifiers of the cities. The
+ *      file is formatted in memory and written with a single call.
+ */
+bool export_tsplib_tour(const std::string filename, const Instance& cities, const std::vector<int>& tsp_route)
+{
+    std::string contents;
+    contents.reserve(tsp_route.size() * 9 + 256);
+    contents += "NAME : " + (cities.name.empty() ? std::string("random") : cities.name) + ".tour\n";
+    contents += "TYPE : TOUR\n";
+    contents += "DIMENSION : " + std::to_string(tsp_route.size()) + "\n";
+    contents += "TOUR_SECTION\n";
+    char buffer[16];
+    for (const int node : tsp_route)
+    {
+        char* last = std::to_chars(buffer, buffer + sizeof(buffer), cities.id[node] + 1).ptr;
+        contents.append(buffer, last);
+        contents += '\n';
+    }
+    contents += "-1\nEOF\n";
+
+    std::ofstream export_stream(filename, std::ios::binary);
+    export_stream.write(contents.data(), contents.size());
+    if (!export_stream)
+    {
+        std::cout << "[Warning]: Could not write \"" << filename << "\"\n\t[\"File not written\" fault masked]" << std::endl;
+        return false;
+    }
+    return true;
+}
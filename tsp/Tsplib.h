@@ -0,0 +1,22 @@
+/**
+ * Tsplib.h
+ *
+ * In this header file, we define the functions that
+ * read and write TSPLIB files. Instances (`.tsp`) and
+ * tours (`.tour`) are memory mapped and parsed in place,
+ * straight into the structure of arrays of the instance,
+ * without copying the file into an intermediate buffer.
+ * That way files with millions of cities are loaded in
+ * a fraction of a second.
+ *
+ * @remark http://comopt.ifi.uni-heidelberg.de/software/TSPLIB95/tsp95.pdf
+ */
+
+#pragma once
+
+#include "Common.h"
+#include "Instance.h"
+
+bool load_tsplib_instance(const std::string filename, Instance& cities);
+bool load_tsplib_tour(const std::string filename, const Instance& cities, std::vector<int>& tsp_route);
+bool export_tsplib_tour(const std::string filename, const Instance& cities, const std::vector<int>& tsp_route);
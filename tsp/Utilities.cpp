@@ -4,7 +4,8 @@
 /**
  * Implements Naive TSP.
  * 
- * @param[in, out] cities 
+ * @param[in, out] cities the dataset which is to be optimized
+ * @param[in] settings the run time settings (number of iterations and seed)
  * 
  * @note the TSP route is actually generated connecting the different
  *      nodes that are found inside the `cities` variable. Therefore,
@@ -20,13 +21,13 @@
  *      - If the later cost is less, then keep the later TSP route
  *      - Else change it back the way it was
  */
-void naive_tsp(std::array<std::pair<int, int>, N_POINTS>& cities)
+void naive_tsp(Instance& cities, const Settings& settings)
 {
-    std::random_device rd;                                      /// non-deterministic generator
-    std::mt19937 gen(rd());                                     /// to seed mersenne twister
-    std::uniform_int_distribution<int> dist(1, N_POINTS - 2);   /// distribute results between 0 and N_POINTS - 2 squared inclusive
+    Xoshiro256 gen = random_stream(settings.seed, STREAM_MAIN); /// The stream of the run (see `Random.h`)
+    std::uniform_int_distribution<int> dist(1, cities.size() - 2);
+                                                                /// distribute results between 1 and n_points - 2 inclusive
 
-    for (int i = 0; i < ITERATIONS; i += 1)
+    for (int i = 0; i < settings.iterations; i += 1)
     {
         int point_index_one = dist(gen);                        /// Select the first point for the algorithm
         int point_index_two = dist(gen);                        /// Select the second point for the algorithm
@@ -35,22 +36,24 @@ void naive_tsp(std::array<std::pair<int, int>, N_POINTS>& cities)
         if(is_neighbor == 1 && point_index_one > point_index_two) { std::swap(point_index_one, point_index_two); }
                                                                 /// Sort points in ascending order if those are neighbors to solve fault in distance computation
         long double diff_before = euclidean_difference(is_neighbor,
-            cities.at(point_index_one - 1),
-            cities.at(point_index_one),
-            cities.at(point_index_one + 1),
-            cities.at(point_index_two - 1),
-            cities.at(point_index_two),
-            cities.at(point_index_two + 1));                    /// Compute the TSP tour cost before permutation
+            cities,
+            point_index_one - 1,
+            point_index_one,
+            point_index_one + 1,
+            point_index_two - 1,
+            point_index_two,
+            point_index_two + 1);                               /// Compute the TSP tour cost before permutation
         long double diff_after = euclidean_difference(is_neighbor,
-            cities.at(point_index_one - 1),
-            cities.at(point_index_two),
-            cities.at(point_index_one + 1),
-            cities.at(point_index_two - 1),
-            cities.at(point_index_one),
-            cities.at(point_index_two + 1));                    /// Compute the TSP tour cost after the permutation
+            cities,
+            point_index_one - 1,
+            point_index_two,
+            point_index_one + 1,
+            point_index_two - 1,
+            point_index_one,
+            point_index_two + 1);                               /// Compute the TSP tour cost after the permutation
         if (diff_before > diff_after)                           /// Compare the two computed costs
         {
-            std::swap(cities.at(point_index_one), cities.at(point_index_two));
+            cities.swap(point_index_one, point_index_two);
                                                                 /// Change the order of the cities if random permutation gave better results
             if (TEST_MODE)
             {
@@ -66,72 +69,158 @@ void naive_tsp(std::array<std::pair<int, int>, N_POINTS>& cities)
 /**
  * Implements Naive TSP. This is a fork of the `naive_tsp` function above, parallelized with OpenMP 4.0.
  *
- * @param[in, out] cities
+ * @param[in, out] cities the dataset which is to be optimized
+ * @param[in] settings the run time settings (number of iterations and seed)
+ *
+ * @note the route is split into 2 * `NAIVE_SEGMENTS` blocks, which are paired with a round robin
+ *      schedule, so every iteration pairs every block with a different block. Each pair only swaps
+ *      its own cities, so the threads improve their pairs independently inside a single parallel
+ *      region. The city between 2 blocks is read by both of them and swapped by none of them, so the
+ *      boundaries are moved by half a block every other iteration, so that every city is swapped.
+ *      Every pair owns a random stream, so the route does not depend on the number of threads.
+ *
+ * @remark https://en.wikipedia.org/wiki/Round-robin_tournament#Circle_method
  */
-void naive_tsp_parallel(std::array<std::pair<int, int>, N_POINTS>& cities)
+void naive_tsp_parallel(Instance& cities, const Settings& settings)
 {
-    std::random_device rd;                                      /// non-deterministic generator
-    std::mt19937 gen(rd());                                     /// to seed mersenne twister
-    std::uniform_int_distribution<int> dist(1, N_POINTS - 2);   /// distribute results between 0 and N_POINTS - 2 inclusive
+    const int n_points = cities.size();
+    const int n_pairs = std::max(1, std::min(NAIVE_SEGMENTS, (n_points - 2) / 8));
+    const int n_blocks = 2 * n_pairs;                           /// Every block holds at least 3 cities that it may swap, on instances of 10 cities or more
+    const int block_size = (n_points - 2) / n_blocks;
 
-    std::random_device perm_rd;                                 /// non-deterministic generator
-    std::mt19937 perm_gen(perm_rd());                           /// to seed mersenne twister
-    std::uniform_real_distribution<float> perm_dist(0, 1);      /// distribute results between 0 and 1 inclusive
+    std::vector<Xoshiro256> pair_gen;
+    pair_gen.reserve(n_pairs);
+    for (int p = 0; p < n_pairs; p += 1)
+    {
+        pair_gen.push_back(random_stream(settings.seed, STREAM_THREADS + p));
+    }
+
+    auto block_of = [&](const int block, const int shift) -> std::pair<int, int>
+    {
+        const int first = (block == 0 ? 1 : block * block_size + shift + 1);
+        const int last = (block == n_blocks - 1 ? n_points - 2 : (block + 1) * block_size + shift - 1);
+        return std::make_pair(first, std::max(first - 1, last));
+    };                                                          /// Returns the first and the last city that a block may swap, while its boundaries stay in place
 
-    for (int i = 0; i < ITERATIONS; i += 1)                     /// Precompute around {`N_POINTS` divided by 2} permutations 
+#pragma omp parallel num_threads(N_THREADS)
+    for (int i = 0; i < settings.iterations; i += 1)
     {
-        std::vector<int> permutations;
-        permutations.reserve((int)(N_POINTS / 2));
-        float const_prob = 0.0;
-        for (int j = 1; j < N_POINTS - 2; j += 1)
+        const int shift = (i % 2 == 0 ? 0 : block_size / 2);    /// Move the boundaries between the blocks every other iteration
+        const int round = i % std::max(1, n_blocks - 1);
+#pragma omp for schedule(static)
+        for (int p = 0; p < n_pairs; p += 1)
         {
-            if (perm_dist(perm_gen) - const_prob > NAIVE_PROBABILITY)
+            const int block_one = (p == 0 ? n_blocks - 1 : (round + p) % (n_blocks - 1));
+            const int block_two = (p == 0 ? round : (round - p + n_blocks - 1) % (n_blocks - 1));
+                                                                /// The circle method pairs the last block with the others in turn, while the rest rotate around it
+            const std::pair<int, int> one = block_of(block_one, shift);
+            const std::pair<int, int> two = block_of(block_two, shift);
+            const int size_one = one.second - one.first + 1;
+            const int n_cities = size_one + two.second - two.first + 1;
+            if (n_cities < 2) { continue; }
+            std::uniform_int_distribution<int> dist(0, n_cities - 1);
+                                                                /// distribute results among the cities of both blocks
+            auto position = [&](const int draw) { return (draw < size_one ? one.first + draw : two.first + draw - size_one); };
+            const int n_swaps = n_cities / 4;                   /// About as many swaps as the pairs of random cities that the serial version used to draw for the whole route
+            for (int k = 0; k < n_swaps; k += 1)
             {
-                permutations.push_back(j);                      /// If a node is chosen to be added in the permutation vector 
-                const_prob = 1.0;                               /// then make sure not to chose a neighbor, since the permutations will be executed
-            }                                                   /// in parallel and there is a chance of a false distance calculation
-            else
+                int point_index_one = position(dist(pair_gen[p]));
+                int point_index_two = position(dist(pair_gen[p]));
+                int is_neighbor = (std::abs(point_index_one - point_index_two) == 1 ? 1 : 0);
+                if (is_neighbor == 1 && point_index_one > point_index_two) { std::swap(point_index_one, point_index_two); }
+                long double diff_before = euclidean_difference(is_neighbor,
+                    cities,
+                    point_index_one - 1,
+                    point_index_one,
+                    point_index_one + 1,
+                    point_index_two - 1,
+                    point_index_two,
+                    point_index_two + 1);
+                long double diff_after = euclidean_difference(is_neighbor,
+                    cities,
+                    point_index_one - 1,
+                    point_index_two,
+                    point_index_one + 1,
+                    point_index_two - 1,
+                    point_index_one,
+                    point_index_two + 1);
+                if (diff_before > diff_after)
+                {
+                    cities.swap(point_index_two, point_index_one);
+                }
+            }
+        }                                                       /// The implicit barrier of the loop ends the iteration, before the blocks move
+        if (TEST_MODE)
+        {
+#pragma omp single
             {
-                const_prob = 0.0;
+                print_tsp_tour_cost(tsp_tour_cost(cities));     /// The route is only read once no thread swaps its cities
+                export_graph_newtork_array(cities, "graph" + std::to_string(i));
             }
         }
+    }
+}
 
-        std::shuffle(permutations.begin(), permutations.end(), std::mt19937{ std::random_device{}() });
-                                                                /// Shuffle the permutation vector precomputed above to generate random pairs for permutation
-#pragma omp parallel for num_threads(N_THREADS) schedule(runtime)
-        for (int k = 0; k < permutations.size() - 1; k += 2)
+/**
+ * Finds the closest unexplored cities to a city.
+ * 
+ * @param[in] cities the dataset
+ * @param[in] candidates the candidate lists of `cities`
+ * @param[in] tree the k-d tree of `cities`, where explored cities have been erased, or nullptr if the metric does not allow it
+ * @param[in] explored the flag of each city that marks it as explored
+ * @param[in] city the city the salesman is at
+ * @param[in] count the number of closest cities requested (1 or 2)
+ * 
+ * @return the closest cities in ascending distance. An element is -1 if not enough cities remain unexplored
+ * 
+ * @note the candidate list of `city` is sorted in ascending distance. Therefore, the first unexplored
+ *      candidates are the closest unexplored cities, and the k-d tree (or a scan of all the cities)
+ *      is only queried when the candidate list has been exhausted.
+ */
+std::array<int, 2> closest_unexplored(
+    const Instance&                                         cities,
+    const CandidateList&                                    candidates,
+    const KdTree*                                           tree,
+    const std::vector<char>&                                explored,
+    const int                                               city,
+    const int                                               count)
+{
+    std::array<int, 2> neighbors_idx = { -1, -1 };
+    int found = 0;
+    const int* neighbors = candidates.neighbors_of(city);
+    for (int j = 0; j < candidates.k && found < count; j += 1)
+    {
+        if (!explored[neighbors[j]]) { neighbors_idx.at(found++) = neighbors[j]; }
+    }
+    if (found == count) { return neighbors_idx; }           /// The candidate list holds the closest unexplored cities
+    if (tree != nullptr)
+    {
+        if (count == 1) { return { tree->nearest(city), -1 }; }
+        return tree->nearest_two(city);
+    }
+    std::array<long double, 2> neighbors_val = { std::numeric_limits<long double>::infinity(), std::numeric_limits<long double>::infinity() };
+    neighbors_idx.fill(-1);
+    for (int j = 0; j < cities.size(); j += 1)              /// Iterate through all possible cities and find the ones with the minimum distance
+    {
+        if (explored[j]) { continue; }
+        long double cost = tsp_hop_cost(cities, city, j).second;
+        if (cost < neighbors_val.at(count - 1))
         {
-            int point_index_one = permutations.at(k);
-            int point_index_two = permutations.at(k + 1);
-            int is_neighbor = (std::abs(point_index_one - point_index_two) == 1 ? 1 : 0);
-            long double diff_before = euclidean_difference(is_neighbor,
-                cities.at(point_index_one - 1),
-                cities.at(point_index_one),
-                cities.at(point_index_one + 1),
-                cities.at(point_index_two - 1),
-                cities.at(point_index_two),
-                cities.at(point_index_two + 1));
-            long double diff_after = euclidean_difference(is_neighbor,
-                cities.at(point_index_one - 1),
-                cities.at(point_index_two),
-                cities.at(point_index_one + 1),
-                cities.at(point_index_two - 1),
-                cities.at(point_index_one),
-                cities.at(point_index_two + 1));
-            if (diff_before > diff_after)
+            if (count == 2 && cost < neighbors_val.at(0))
             {
-                std::swap(cities.at(point_index_two), cities.at(point_index_one));
-                if (TEST_MODE)
-                {
-#pragma omp critical
-                    {
-                        print_tsp_tour_cost(tsp_tour_cost(cities));
-                        export_graph_newtork_array(cities, "graph" + std::to_string(i));
-                    }
-                }
+                neighbors_idx.at(1) = neighbors_idx.at(0);
+                neighbors_val.at(1) = neighbors_val.at(0);
+                neighbors_idx.at(0) = j;
+                neighbors_val.at(0) = cost;
+            }
+            else
+            {
+                neighbors_idx.at(count - 1) = j;
+                neighbors_val.at(count - 1) = cost;
             }
         }
     }
+    return neighbors_idx;
 }
 
 /**
@@ -139,6 +228,7 @@ void naive_tsp_parallel(std::array<std::pair<int, int>, N_POINTS>& cities)
  * as the project states the Heinritz - Hsiao algorithm.
  * 
  * @param[in, out] cities the dataset which is to be optimized
+ * @param[in, out] candidates the candidate lists of `cities` (see `Candidates.h`), renumbered along with `cities`
  * 
  * @remark Heinritz - Hsiao:
  *      - Place the travelling salesman in a city
@@ -146,29 +236,35 @@ void naive_tsp_parallel(std::array<std::pair<int, int>, N_POINTS>& cities)
  *      -   Find the closest city to the city the salesman is at
  *      -   Go to that city
  *      - Until all cities have been explored
+ * 
+ * @note the closest city is looked up in the candidate list of the city the salesman
+ *      is at. Only if all the candidates have been explored, the closest city is found 
+ *      with a k-d tree (see `KdTree.h`) in roughly O(log n), or by scanning all the 
+ *      cities for instances where the metric does not allow a k-d tree.
  */
-void heinritz_hsiao(std::array<std::pair<int, int>, N_POINTS>& cities)
+void heinritz_hsiao(Instance& cities, CandidateList& candidates)
 {
-    for (int i = 0; i < N_POINTS - 1; i += 1)
+    const int n_points = cities.size();
+    std::unique_ptr<KdTree> tree;                           /// Declare a spatial index over the cities
+    if (cities.is_geometric()) { tree = std::make_unique<KdTree>(cities); }
+    std::vector<char> explored(n_points, 0);                /// Declare a vector to flag the explored cities
+    std::vector<int> order(n_points);                       /// Declare a vector to store the route
+    order.at(0) = 0;                                        /// Place the travelling salesman in the first city
+    explored.at(0) = 1;
+    if (tree) { tree->erase(0); }
+    for (int i = 0; i < n_points - 1; i += 1)
     {
-        long double min_val = std::numeric_limits<double>::infinity();
-        int min_idx = -1;
-        for (int j = i + 1; j < N_POINTS; j += 1)           /// Iterate through all possible cities and find the one with the minimum Euclidean distance
-        {
-            long double cost = tsp_hop_cost(cities.at(i), cities.at(j)).second;
-            if (cost < min_val)                             /// If a (local) minimum is found, update indicators
-            {
-                min_idx = j;
-                min_val = cost;
-            }
-        }
-        std::swap(cities.at(i + 1), cities.at(min_idx));    /// Swap the city order with respect to the selected city
-        if (TEST_MODE)                                      /// If in debug mode, print out some information on the algorithm's progress
-        {
-            std::cout << "[ITERATION " << i << "]";
-            print_tsp_tour_cost(tsp_tour_cost(cities));
-            export_graph_newtork_array(cities, "graph" + std::to_string(i));
-        }
+        order.at(i + 1) = closest_unexplored(cities, candidates, tree.get(), explored, order.at(i), 1).at(0);
+                                                            /// Find the closest city that has not been explored
+        explored.at(order.at(i + 1)) = 1;                   /// Mark that city as explored
+        if (tree) { tree->erase(order.at(i + 1)); }
+    }
+    cities.reorder(order);                                  /// Reorder the cities with respect to the route
+    reorder_candidates(order, candidates);                  /// Keep the candidate lists valid for the local search
+    if (TEST_MODE)                                          /// If in debug mode, print out some information on the algorithm's result
+    {
+        print_tsp_tour_cost(tsp_tour_cost(cities));
+        export_graph_newtork_array(cities, "graph");
     }
 }
 
@@ -176,6 +272,8 @@ void heinritz_hsiao(std::array<std::pair<int, int>, N_POINTS>& cities)
  * Implements TSP with naive nearest neighbor.
  *
  * @param[in, out] cities the dataset which is to be optimized
+ * @param[in, out] candidates the candidate lists of `cities` (see `Candidates.h`), renumbered along with `cities`
+ * @param[in] settings the run time settings (seed)
  *
  * @remark Naive Heinritz - Hsiao:
  *      - Place the travelling salesman in a city
@@ -184,108 +282,86 @@ void heinritz_hsiao(std::array<std::pair<int, int>, N_POINTS>& cities)
  *      -   Randomly one of those cities
  *      -   Go to that city
  *      - Until all cities have been explored
+ * 
+ * @note as in heinritz_hsiao(), the 2 closest cities are looked up in the candidate lists first.
  */
-void naive_heinritz_hsiao(std::array<std::pair<int, int>, N_POINTS>& cities)
+void naive_heinritz_hsiao(Instance& cities, CandidateList& candidates, const Settings& settings)
 {
-    std::random_device naive_rd;                                /// non-deterministic generator
-    std::mt19937 naive_gen(naive_rd());                         /// to seed mersenne twister
+    const int n_points = cities.size();
+    Xoshiro256 naive_gen = random_stream(settings.seed, STREAM_MAIN);
+                                                                /// The stream of the run (see `Random.h`)
     std::uniform_real_distribution<double> naive_dist(0, 1);    /// distribute results between 0 and 1 inclusive
-    for (int i = 0; i < N_POINTS - 2; i += 1)
+    std::unique_ptr<KdTree> tree;
+    if (cities.is_geometric()) { tree = std::make_unique<KdTree>(cities); }
+    std::vector<char> explored(n_points, 0);
+    std::vector<int> order(n_points);
+    order.at(0) = 0;
+    explored.at(0) = 1;
+    if (tree) { tree->erase(0); }
+    for (int i = 0; i < n_points - 1; i += 1)
     {
-        std::array<int, 2> neighbors_idx;                       /// Declare an array to store the indexes corresponding to the two closest cities
-        long double min_val = std::numeric_limits<double>::infinity();
-        for (int j = i + 1; j < N_POINTS; j += 1)
-        {
-            long double cost = tsp_hop_cost(cities.at(i), cities.at(j)).second;
-            if (cost < min_val)                                 /// If a (local) minimum is found, then update `neighbors_idx` array
-            {
-                min_val = cost;
-                std::swap(neighbors_idx.at(0), neighbors_idx.at(1));
-                neighbors_idx.at(0) = j;
-            }
-        }
-        std::swap(cities.at(i + 1), cities.at(neighbors_idx.at((NAIVE_PROBABILITY > naive_dist(naive_gen) ? 1 : 0))));
-                                                                /// Swap the city order with respect to the two closest cities given a `NAIVE_PROBABILITY`
-        if (TEST_MODE)                                          /// If in debug mode, print out some information on the algorithm's progress
-        {
-            std::cout << "[ITERATION " << i << "]";
-            print_tsp_tour_cost(tsp_tour_cost(cities));
-            export_graph_newtork_array(cities, "graph" + std::to_string(i));
-        }
+        std::array<int, 2> neighbors_idx = closest_unexplored(cities, candidates, tree.get(), explored, order.at(i), 2);
+                                                                /// Find the 2 closest cities that have not been explored
+        order.at(i + 1) = neighbors_idx.at((NAIVE_PROBABILITY > naive_dist(naive_gen) && neighbors_idx.at(1) != -1 ? 1 : 0));
+                                                                /// Select one of those cities given a `NAIVE_PROBABILITY`
+        explored.at(order.at(i + 1)) = 1;
+        if (tree) { tree->erase(order.at(i + 1)); }
+    }
+    cities.reorder(order);
+    reorder_candidates(order, candidates);
+    if (TEST_MODE)
+    {
+        print_tsp_tour_cost(tsp_tour_cost(cities));
+        export_graph_newtork_array(cities, "graph");
     }
 }
 
+#pragma omp declare reduction(nearest_two : NearestTwo : omp_out.merge(omp_in)) initializer(omp_priv = NearestTwo())
+                                                                /// Merges the 2 closest cities found by each thread (see `NearestTwo` in Kernel.h)
+
 /**
  * Implements TSP with naive nearest neighbor. This is a fork of the `naive_heinritz_hsiao` function above, parallelized with OpenMP 4.0.
  *
  * @param[in, out] cities the dataset which is to be optimized
+ * @param[in] settings the run time settings (seed)
+ *
+ * @note the whole route is built inside a single parallel region. In every step, the unexplored
+ *      cities (the cities after the salesman) are split into blocks of `NEAREST_BLOCK` cities, every
+ *      thread scans its blocks with the vectorized `nearest_two()` kernel, and the 2 closest cities
+ *      of the threads are merged by the `nearest_two` reduction. A single thread then moves the
+ *      salesman, while the others wait at the barrier. The blocks and the merge do not depend on
+ *      the number of threads, so neither does the route.
  */
-void naive_heinritz_hsiao_parallel(std::array<std::pair<int, int>, N_POINTS>& cities)
+void naive_heinritz_hsiao_parallel(Instance& cities, const Settings& settings)
 {
-    std::random_device naive_rd;                                /// non-deterministic generator
-    std::mt19937 naive_gen(naive_rd());                         /// to seed mersenne twister
+    constexpr int NEAREST_BLOCK = 4096;                         /// The number of cities of a block, which is the unit of work of the threads
+    const int n_points = cities.size();
+    Xoshiro256 naive_gen = random_stream(settings.seed, STREAM_MAIN);
+                                                                /// The random choices are made by a single thread, so a single stream suffices
     std::uniform_real_distribution<double> naive_dist(0, 1);    /// distribute results between 0 and 1 inclusive
-    for (int i = 0; i < N_POINTS - 2; i += 1)
+    NearestTwo nearest;                                         /// Declare the 2 closest cities of the current step, shared by the threads
+#pragma omp parallel num_threads(N_THREADS)
+    for (int i = 0; i < n_points - 2; i += 1)
     {
-        std::array<std::array<int, 2>, N_THREADS> neighbors_idx;
-        std::array<std::array<long double, 2>, N_THREADS> neighbors_val;
-        for (int j = 0; j < N_THREADS; j += 1)
+        const int n_blocks = (n_points - i - 1 + NEAREST_BLOCK - 1) / NEAREST_BLOCK;
+#pragma omp for schedule(static) reduction(nearest_two : nearest)
+        for (int block = 0; block < n_blocks; block += 1)       /// Each thread finds its own pair of closest cities
         {
-            neighbors_idx.at(j).fill(i + 1);
-            neighbors_val.at(j).fill(std::numeric_limits<long double>::infinity());
+            const int first = i + 1 + block * NEAREST_BLOCK;
+            nearest.merge(nearest_two(cities, i, first, std::min(n_points, first + NEAREST_BLOCK)));
         }
-#pragma omp parallel for num_threads(N_THREADS) schedule(runtime)
-        for (int j = i + 1; j < N_POINTS; j += 1)               /// Each threads finds its own pair of closest cities
+#pragma omp single
         {
-            long double cost = tsp_hop_cost(cities.at(i), cities.at(j)).second;
-            if (cost < neighbors_val.at(omp_get_thread_num()).at(1))
-            {
-                if (cost < neighbors_val.at(omp_get_thread_num()).at(0))
-                {
-                    neighbors_idx.at(omp_get_thread_num()).at(0) = j;
-                    std::swap(neighbors_idx.at(omp_get_thread_num()).at(0), neighbors_idx.at(omp_get_thread_num()).at(1));
-                    neighbors_val.at(omp_get_thread_num()).at(0) = cost;
-                    std::swap(neighbors_val.at(omp_get_thread_num()).at(0), neighbors_val.at(omp_get_thread_num()).at(1));
-                }
-                else
-                {
-                    neighbors_idx.at(omp_get_thread_num()).at(1) = j;
-                    neighbors_val.at(omp_get_thread_num()).at(1) = cost;
-                }
-            }
-        }
-        std::array<int, 2> reduced_cost_idx;
-        std::array<long double, 2> reduced_cost_val;
-        reduced_cost_val.fill(std::numeric_limits<long double>::infinity());
-        for (int j = 0; j < N_THREADS; j += 1)                  /// When all threads are done comparing distances, this final comparison is performed.
-        {                                                       /// The difference is that now, only N_THREADS x 2 values have to be compared, not N_POINTS x 2.
-            for (int k = 0; k < neighbors_val.at(j).size(); k += 1)
+            const int chosen = nearest.city[(NAIVE_PROBABILITY > naive_dist(naive_gen) ? 1 : 0)];
+            cities.swap(i + 1, chosen);                         /// Update the city order with respect to the 2 closest cities
+            if (TEST_MODE)                                      /// If in debug mode, print out some information on the algorithm's progress
             {
-                if (neighbors_val.at(j).at(k) < reduced_cost_val.at(1) && neighbors_val.at(j).at(k) > 0.0)
-                {                                               /// Update `reduced_cost_idx`, which is the container with the final 2 closest cities
-                    if (neighbors_val.at(j).at(k) < reduced_cost_val.at(0))
-                    {                                           /// A better minimum was found
-                        std::swap(reduced_cost_idx.at(0), reduced_cost_idx.at(1));
-                        reduced_cost_idx.at(0) = neighbors_idx.at(j).at(k);
-                        std::swap(reduced_cost_val.at(0), reduced_cost_val.at(1));
-                        reduced_cost_val.at(0) = neighbors_val.at(j).at(k);
-                    }
-                    else
-                    {                                           /// A second better minimum was found
-                        reduced_cost_idx.at(1) = neighbors_idx.at(j).at(k);
-                        reduced_cost_val.at(1) = neighbors_val.at(j).at(k);
-                    }
-                }
+                std::cout << "[ITERATION " << i << "][COST " << tsp_hop_cost(cities, i, i + 1).second << "]\t";
+                print_tsp_tour_cost(tsp_tour_cost(cities));
+                export_graph_newtork_array(cities, "graph" + std::to_string(i));
             }
-        }
-        std::swap(cities.at(i + 1), cities.at(reduced_cost_idx.at((NAIVE_PROBABILITY > naive_dist(naive_gen) ? 1 : 0))));
-                                                                /// Update the city order with respect to the `reduced_cost_idx`
-        if (TEST_MODE)                                          /// If in debug mode, print out some information on the algorithm's progress
-        {
-            std::cout << "[ITERATION " << i << "][SECOND HIGHEST COST " << reduced_cost_val.at((NAIVE_PROBABILITY > naive_dist(naive_gen) ? 1 : 0)) << "]\t";
-            print_tsp_tour_cost(tsp_tour_cost(cities));
-            export_graph_newtork_array(cities, "graph" + std::to_string(i));
-        }
+            nearest = NearestTwo();                             /// Reset the shared state for the reduction of the next step
+        }                                                       /// The implicit barrier keeps the threads from scanning before the salesman moves
     }
 }
 
@@ -293,38 +369,53 @@ void naive_heinritz_hsiao_parallel(std::array<std::pair<int, int>, N_POINTS>& ci
  * Implements ACS.
  * 
  * param[in] cities the dataset of the random cities to be explored
+ * @param[in] candidates the candidate lists of `cities` (see `Candidates.h`)
+ * @param[in] settings the run time settings (number of iterations and seed)
+ * @param[in, out] tsp_route the node indexes of the TSP route found by the ants with respect to `cities` variable
  * 
- * @note the ACS requires a huge ammount of memory. Only the pherormone matrix
- *          requires 100 million double values to be stored, which is around 850 MB 
- *          of memory (according to the Visual Studio Memory Profiler). Then, there
- *          is the `non_explored` vector which is necessary since it keeps a track of 
- *          each ant's explored nodes.
+ * @note the dense pherormone matrix of 10,000 cities requires 100 million double 
+ *          values to be stored, which is around 850 MB of memory (according to the 
+ *          Visual Studio Memory Profiler). Therefore, larger instances use the sparse
+ *          pherormone store (see `pherormone_store()`), which only stores the pherormone
+ *          of the candidate edges, so the ACS takes O(n * k) memory. The compact store
+ *          keeps every edge in a quarter of the memory of the dense matrix.
  * 
  * @remark Ant colony:
  *          - Place N_ANTS in random cities
  *          - For each ant repeat:
- *          -   Evaluate all the possible edges
+ *          -   Evaluate the edges to the unexplored candidates (or to all the unexplored cities, if there are none)
  *          -   Fetch each edge's pherormone
  *          -   Select an edge using Roulette Wheel
  *          -   Leave some pherormone on that edge
  *          - Until ANT_MEMORY is exceeded
+ *          - Keep the best tour of the ants, or the tour extracted from the pherormone
  * 
  * @remark https://staff.washington.edu/paymana/swarm/stutzle99-eaecs.pdf
  * 
  * @remark https://youtu.be/783ZtAF4j5g
  */
-void ant_colony(const std::array<std::pair<int, int>, N_POINTS> cities)
+void ant_colony(const Instance& cities, const CandidateList& candidates, const Settings& settings, std::vector<int>& tsp_route)
 {
-    std::vector<std::array<double, N_POINTS>> pherormone_matrix(N_POINTS);
-                                                                /// Declare the pherormone matrix of dimentions N_POINTS x N_POINTS
-    initialize_pherormone_matrix(pherormone_matrix);            /// Initialize the pherormone matrix
-    std::vector<int> tsp_route;                                 /// Initialize a variable to store the TSP route found by the ants
-    tsp_route.reserve(N_POINTS);                                /// Reserve `N_POINTS` of memory slots to increase performance
-    colonize(cities, pherormone_matrix);                        /// Colonize the map
+    tsp_route.clear();
+    tsp_route.reserve(cities.size());                           /// Reserve `n_points` of memory slots to increase performance
+    ColonyTours tours;                                          /// Declare the best tours found by the ants
+    with_pherormone_store(candidates, cities.size(), settings, [&](auto& pherormone)
+    {
+        colonize(cities, candidates, settings, pherormone, tours);  /// Colonize the map
+        if (tours.best.empty()) { acs_tsp(cities, candidates, pherormone, tsp_route); }
+                                                                /// Extract the TSP route from the pherormone store, unless the best tour was tracked
+        if constexpr (std::is_same_v<std::decay_t<decltype(pherormone)>, DensePherormone>)
+        {
+            if (TEST_MODE)
+            {
+                pherormone.normalize(false);                    /// Apply the pending evaporation before printing the raw matrix
+                print_matrix(pherormone.matrix(), "Pherormone Matrix");
+            }
+        }
+    });
+    if (!tours.best.empty()) { tsp_route.swap(tours.best); }   /// Release the best tour found by the ants
     if (TEST_MODE)                                              /// If in debug mode, print out some information on the algorithm's progress
     {
-        print_matrix(pherormone_matrix, "Pherormone Matrix");
-        acs_tsp(pherormone_matrix, tsp_route);
         double acs_cost = acs_tsp_cost(tsp_route, cities);
         print_acs_tsp(tsp_route);
         std::cout << "\tCost estimated by \"ACS\": " << acs_cost << std::endl;
@@ -336,26 +427,191 @@ void ant_colony(const std::array<std::pair<int, int>, N_POINTS> cities)
  * Implements ACS. This is a fork of the `ant_colony` function above, parallelized with OpenMP 4.0.
  *
  * param[in] cities the dataset of the random cities to be explored
+ * @param[in] candidates the candidate lists of `cities` (see `Candidates.h`)
+ * @param[in] settings the run time settings (number of iterations and seed)
+ * @param[in, out] tsp_route the node indexes of the TSP route found by the ants with respect to `cities` variable
  *
- * @note the parallel version of the ACS requires an even greater ammount of memory
- *          to be reserved. For 10,000 cities, the ammount of memory reserved was
- *          12 GB. That is why the number of cities, which is declared by `N_POINTS`
- *          is better to be less than 2,000 when running ACS.
+ * @note the pherormone store is selected as in ant_colony(). The ants of the parallel
+ *          version only share the pherormone store, so the memory footprint is the same.
  */
-void ant_colony_parallel(const std::array<std::pair<int, int>, N_POINTS> cities)
+void ant_colony_parallel(const Instance& cities, const CandidateList& candidates, const Settings& settings, std::vector<int>& tsp_route)
 {
-    std::vector<std::array<double, N_POINTS>> pherormone_matrix(N_POINTS);
-    initialize_pherormone_matrix(pherormone_matrix);
-    std::vector<int> tsp_route;
-    tsp_route.reserve(N_POINTS);
-    colonize_parallel(cities, pherormone_matrix);               /// Call the parallel version of the colonize() function
+    tsp_route.clear();
+    tsp_route.reserve(cities.size());
+    ColonyTours tours;
+    with_pherormone_store(candidates, cities.size(), settings, [&](auto& pherormone)
+    {
+        colonize_parallel(cities, candidates, settings, pherormone, tours);
+                                                                /// Call the parallel version of the colonize() function
+        if (tours.best.empty()) { acs_tsp(cities, candidates, pherormone, tsp_route); }
+        if constexpr (std::is_same_v<std::decay_t<decltype(pherormone)>, DensePherormone>)
+        {
+            if (TEST_MODE)
+            {
+                pherormone.normalize(false);                    /// Apply the pending evaporation before printing the raw matrix
+                print_matrix(pherormone.matrix(), "Pherormone Matrix");
+            }
+        }
+    });
+    if (!tours.best.empty()) { tsp_route.swap(tours.best); }   /// Release the best tour found by the ants
     if (TEST_MODE)
     {
-        print_matrix(pherormone_matrix, "Pherormone Matrix");
-        acs_tsp(pherormone_matrix, tsp_route);
         double acs_cost = acs_tsp_cost(tsp_route, cities);
         print_acs_tsp(tsp_route);
         std::cout << "\tCost estimated by \"ACS\": " << acs_cost << std::endl;
         export_acs_tsp_route(cities, "acs_tsp", tsp_route);
     }
 }
+
+/**
+ * Implements the Ant Colony System of Dorigo and Gambardella.
+ *
+ * @param[in] cities the dataset of the random cities to be explored
+ * @param[in] candidates the candidate lists of `cities` (see `Candidates.h`)
+ * @param[in] settings the run time settings (number of iterations, number of ants, seed and `q0`)
+ * @param[in, out] tsp_route the node indexes of the best TSP route found by the ants with respect to `cities` variable
+ *
+ * @note the pherormone store is selected as in ant_colony().
+ *
+ * @remark Ant Colony System:
+ *          - Initialize the pherormone of every edge to 1 / (n * L) with the nearest neighbor tour
+ *          - For each iteration repeat:
+ *          -   Place each ant in a random city
+ *          -   Let each ant build a complete tour. In each step, the ant follows its best candidate
+ *              edge with probability `q0`, else it spins the roulette wheel over its candidate edges
+ *          -   Pull the pherormone of every crossed edge back towards its initial value (local update)
+ *          -   Add pherormone only to the edges of the best tour so far (global update)
+ *
+ * @remark https://ieeexplore.ieee.org/document/585892
+ */
+void ant_colony_system(const Instance& cities, const CandidateList& candidates, const Settings& settings, std::vector<int>& tsp_route)
+{
+    ColonyTours tours;
+    with_pherormone_store(candidates, cities.size(), settings, [&](auto& pherormone)
+    {
+        colony_system(cities, candidates, settings, pherormone, tours);
+    });
+    tsp_route.swap(tours.best);
+}
+
+/**
+ * Implements the MAX - MIN Ant System of Stutzle and Hoos.
+ *
+ * @param[in] cities the dataset of the random cities to be explored
+ * @param[in] candidates the candidate lists of `cities` (see `Candidates.h`)
+ * @param[in] settings the run time settings (number of iterations, number of ants, seed and local search)
+ * @param[in, out] tsp_route the node indexes of the best TSP route found by the ants with respect to `cities` variable
+ *
+ * @note the pherormone store is selected as in ant_colony(). The local search selected at run time is
+ *      applied to the tour of every ant, as in the literature, rather than to the final tour only.
+ *
+ * @remark MAX - MIN Ant System:
+ *          - Initialize the trails to tau_max with the nearest neighbor tour
+ *          - For each iteration repeat:
+ *          -   Let each ant build a complete tour with the random proportional rule, and improve it with the local search
+ *          -   Vaporize the trails, and deposit pherormone on the best tour of the iteration (or of the run, periodically)
+ *          -   Clamp the trails to [tau_min, tau_max]
+ *          -   Reinitialize the trails to tau_max if they have stagnated
+ *
+ * @remark https://doi.org/10.1016/S0167-739X(00)00043-1
+ */
+void max_min_ant_system(const Instance& cities, const CandidateList& candidates, const Settings& settings, std::vector<int>& tsp_route)
+{
+    ColonyTours tours;
+    with_pherormone_store(candidates, cities.size(), settings, [&](auto& pherormone)
+    {
+        max_min_system(cities, candidates, settings, pherormone, tours);
+    });
+    tsp_route.swap(tours.best);
+}
+
+/**
+ * Applies the local search selected at run time to the TSP route of any approach.
+ *
+ * @param[in] cities the dataset
+ * @param[in] settings the run time settings (local search flags, parallel local search and candidate lists)
+ * @param[in, out] candidates the candidate lists of `cities`. They are built here if the approach did not build them
+ * @param[in, out] tsp_route the TSP route to be improved, which must visit every city once
+ *
+ * @return the number of improving moves applied
+ *
+ * @note see `local_optimum()` and `local_optimum_parallel()` in `LocalSearch.cpp`.
+ */
+int local_search(const Instance& cities, const Settings& settings, CandidateList& candidates, std::vector<int>& tsp_route)
+{
+    if (settings.local_search == 0) { return 0; }
+    if (candidates.k == 0) { build_candidates(cities, settings.candidates, settings.quadrant_candidates, candidates); }
+    Tour tour(tsp_route);                                   /// Store the route in the representation of the local search
+    const int moves = (settings.parallel_local_search ? local_optimum_parallel(cities, candidates, settings.local_search, tour, N_THREADS)
+        : local_optimum(cities, candidates, settings.local_search, tour));
+    tour.to_route(tsp_route);
+    if (TEST_MODE)
+    {
+        std::cout << "\tLocal search moves: " << moves << std::endl;
+        export_acs_tsp_route(cities, "local_search", tsp_route);
+    }
+    return moves;
+}
+
+/**
+ * Implements TSP with a space filling curve.
+ *
+ * @param[in] cities the dataset
+ * @param[out] tsp_route the TSP route found
+ *
+ * @remark Space filling curve:
+ *      - Cover the bounding box of the cities with a Hilbert curve
+ *      - Visit the cities in the order in which the curve visits them
+ *
+ * @note this costs O(n log n), so it is the fastest starting route for the local search. If the
+ *      cities were renumbered along the curve (`--renumber on`), the route is the order of `cities`.
+ */
+void space_filling_curve(const Instance& cities, std::vector<int>& tsp_route)
+{
+    hilbert_order(cities, tsp_route);
+    if (TEST_MODE)
+    {
+        export_acs_tsp_route(cities, "space_filling_curve", tsp_route);
+    }
+}
+
+/**
+ * Implements TSP with Lin - Kernighan.
+ *
+ * @param[in, out] cities the dataset which is to be optimized
+ * @param[in] settings the run time settings (time budget, maximum number of kicks and seed)
+ * @param[in, out] candidates the candidate lists of `cities` (see `Candidates.h`)
+ * @param[in, out] tsp_route the TSP route found
+ *
+ * @return the number of kicks applied, which the time budget usually bounds well before `settings.iterations`
+ *
+ * @remark Lin - Kernighan:
+ *      - Build a TSP route with the nearest neighbor approach
+ *      - Improve it with 2-opt and Or-opt (segment insertion) moves
+ *      - Improve it with Lin - Kernighan moves of up to `LK_DEPTH` flips
+ *      - Repeat, until the time budget or the number of kicks is exhausted:
+ *      -   Kick the route and improve it again with Lin - Kernighan moves
+ *      -   Undo the kick, if the route did not become shorter
+ */
+int lin_kernighan(Instance& cities, const Settings& settings, CandidateList& candidates, std::vector<int>& tsp_route)
+{
+    const std::chrono::time_point<std::chrono::system_clock> deadline = std::chrono::system_clock::now()
+        + std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::duration<double>(settings.time_limit));
+                                                            /// Compute the time point when the search must stop
+    heinritz_hsiao(cities, candidates);                     /// Build the initial route, which is the order of `cities`
+    tsp_route.resize(cities.size());
+    std::iota(tsp_route.begin(), tsp_route.end(), 0);
+    Tour tour(tsp_route);
+    two_opt(cities, candidates, tour);
+    or_opt(cities, candidates, tour);
+    LinKernighan search(cities, candidates, tour);
+    const int moves = search.optimize(deadline);
+    const std::pair<int, int> kicks = search.perturb(settings.iterations, deadline, settings.seed);
+    tour.to_route(tsp_route);
+    if (TEST_MODE)
+    {
+        std::cout << "\tLin - Kernighan moves: " << moves << ", accepted kicks: " << kicks.second << ", cost: " << search.cost() << std::endl;
+        export_acs_tsp_route(cities, "lin_kernighan", tsp_route);
+    }
+    return kicks.first;
+}
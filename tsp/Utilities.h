@@ -12,15 +12,29 @@
 
 #include "Common.h"
 #include "Distance.h"
+#include "Instance.h"
+#include "KdTree.h"
+#include "Kernel.h"
+#include "Hilbert.h"
+#include "Candidates.h"
+#include "Random.h"
+#include "LocalSearch.h"
+#include "LinKernighan.h"
 #include "Colonize.h"
 #include "Interface.h"
 #include "Pherormone.h"
 #include "Validation.h"
 
-void naive_tsp(std::array<std::pair<int, int>, N_POINTS>& cities);
-void naive_tsp_parallel(std::array<std::pair<int, int>, N_POINTS>& cities);
-void heinritz_hsiao(std::array<std::pair<int, int>, N_POINTS>& cities);
-void naive_heinritz_hsiao(std::array<std::pair<int, int>, N_POINTS>& cities);
-void naive_heinritz_hsiao_parallel(std::array<std::pair<int, int>, N_POINTS>& cities);
-void ant_colony(const std::array<std::pair<int, int>, N_POINTS> cities);
-void ant_colony_parallel(const std::array<std::pair<int, int>, N_POINTS> cities);
+void naive_tsp(Instance& cities, const Settings& settings);
+void naive_tsp_parallel(Instance& cities, const Settings& settings);
+std::array<int, 2> closest_unexplored(const Instance& cities, const CandidateList& candidates, const KdTree* tree, const std::vector<char>& explored, const int city, const int count);
+void heinritz_hsiao(Instance& cities, CandidateList& candidates);
+void naive_heinritz_hsiao(Instance& cities, CandidateList& candidates, const Settings& settings);
+void naive_heinritz_hsiao_parallel(Instance& cities, const Settings& settings);
+void ant_colony(const Instance& cities, const CandidateList& candidates, const Settings& settings, std::vector<int>& tsp_route);
+void ant_colony_parallel(const Instance& cities, const CandidateList& candidates, const Settings& settings, std::vector<int>& tsp_route);
+void ant_colony_system(const Instance& cities, const CandidateList& candidates, const Settings& settings, std::vector<int>& tsp_route);
+void max_min_ant_system(const Instance& cities, const CandidateList& candidates, const Settings& settings, std::vector<int>& tsp_route);
+int local_search(const Instance& cities, const Settings& settings, CandidateList& candidates, std::vector<int>& tsp_route);
+void space_filling_curve(const Instance& cities, std::vector<int>& tsp_route);
+int lin_kernighan(Instance& cities, const Settings& settings, CandidateList& candidates, std::vector<int>& tsp_route);
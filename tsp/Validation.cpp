@@ -18,13 +18,13 @@
  *      directory with the project. If you want to store the data to a custom directory, then
  *      change the proper line of code.
  */
-void export_graph_newtork_array(const std::array<std::pair<int, int>, N_POINTS> cities, std::string filename)
+void export_graph_newtork_array(const Instance& cities, std::string filename)
 {
     std::ofstream export_stream;
     export_stream.open("./data/" + filename + ".csv");      /// If you want to store the data into a different directory change "./data/" to whatever you want
     for (int i = 0; i < cities.size(); i += 1)
     {
-        export_stream << cities.at(i).first << "," << cities.at(i).second << std::endl;
+        export_stream << cities.x[i] << "," << cities.y[i] << std::endl;
     }
     export_stream.close();
 }
@@ -44,13 +44,13 @@ void export_graph_newtork_array(const std::array<std::pair<int, int>, N_POINTS>
  *      directory with the project. If you want to store the data to a custom directory, then
  *      change the proper line of code.
  */
-void export_acs_tsp_route(const std::array<std::pair<int, int>, N_POINTS> cities, std::string filename, const std::vector<int> tsp_route)
+void export_acs_tsp_route(const Instance& cities, std::string filename, const std::vector<int> tsp_route)
 {
     std::ofstream export_stream;
     export_stream.open("./data/" + filename + ".csv");      /// If you want to store the data into a different directory change "./data/" to whatever you want
     for (int i = 0; i < tsp_route.size(); i += 1)
     {
-        export_stream << cities.at(tsp_route.at(i)).first << "," << cities.at(tsp_route.at(i)).second << std::endl;
+        export_stream << cities.x[tsp_route.at(i)] << "," << cities.y[tsp_route.at(i)] << std::endl;
     }
     export_stream.close();
 }
@@ -12,6 +12,7 @@
 #pragma once
 
 #include "Common.h"
+#include "Instance.h"
 
-void export_graph_newtork_array(const std::array<std::pair<int, int>, N_POINTS> cities, std::string filename);
-void export_acs_tsp_route(const std::array<std::pair<int, int>, N_POINTS> cities, std::string filename, const std::vector<int> tsp_route);
+void export_graph_newtork_array(const Instance& cities, std::string filename);
+void export_acs_tsp_route(const Instance& cities, std::string filename, const std::vector<int> tsp_route);